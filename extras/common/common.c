@@ -8,6 +8,12 @@
 #define TINA_JOBS_IMPLEMENTATION
 #include "tina_jobs.h"
 
+#define TINA_RUNLOOP_IMPLEMENTATION
+#include "tina_runloop.h"
+
+#define TINA_IO_IMPLEMENTATION
+#include "tina_io.h"
+
 #include "common.h"
 
 #if defined(__unix__) || defined(__APPLE__)
@@ -61,6 +67,9 @@ void common_start_worker_threads(unsigned thread_count, tina_scheduler* sched, u
 		(*worker) = (worker_context){.sched = sched, .queue_idx = queue_idx, .thread_id = i};
 		thrd_create(&worker->thread, common_worker_body, worker);
 	}
+	
+	// Wait until all of the workers are running. Otherwise a worker that starts late can miss tina_scheduler_interrupt().
+	while(tina_scheduler_queue_workers(sched, queue_idx) < WORKER_COUNT) thrd_yield();
 }
 
 unsigned common_worker_count(void){return WORKER_COUNT;}
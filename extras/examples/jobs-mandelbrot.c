@@ -431,7 +431,8 @@ static bool visit_tile(tile_node* node, tile_node** request_queue){
 static void app_display(void){
 	// Run jobs to load textures.
 	tina_scheduler_run(SCHED, QUEUE_GFX_WAIT, TINA_RUN_FLUSH);
-	tina_scheduler_run(SCHED, QUEUE_GFX, TINA_RUN_FLUSH);
+	// Cap the time spent uploading textures so a burst of finished tiles can't blow the frame budget.
+	tina_scheduler_run_budget(SCHED, QUEUE_GFX, tina_scheduler_now(SCHED) + 4000000, 0);
 	TIMESTAMP++;
 	
 	int w = sapp_width(), h = sapp_height();
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+
+#define STACK_SIZE (4*1024*1024)
+
+typedef struct {
+	uint8_t* buffer;
+	unsigned depth;
+} recurse_ctx;
+
+// Burn some stack per frame so the recursion needs much more than a typical fiber stack.
+static unsigned recurse(recurse_ctx* ctx, unsigned depth){
+	volatile uint8_t frame[256];
+	frame[0] = (uint8_t)depth;
+	assert((uint8_t*)frame >= ctx->buffer && (uint8_t*)frame < ctx->buffer + STACK_SIZE);
+	
+	if(depth == ctx->depth) return depth;
+	return recurse(ctx, depth + 1) + (frame[0] - (uint8_t)depth);
+}
+
+static void* deep_call(void* arg){
+	recurse_ctx* ctx = arg;
+	return (void*)(uintptr_t)recurse(ctx, 0);
+}
+
+static void* coro_body(tina* coro, void* value){
+	recurse_ctx* ctx = coro->user_data;
+	// Borrow the big stack from inside of a coroutine with a small one.
+	value = tina_call_on_stack(ctx->buffer, STACK_SIZE, deep_call, ctx);
+	tina_yield(coro, value);
+	return NULL;
+}
+
+int main(void){
+	recurse_ctx ctx = {.buffer = malloc(STACK_SIZE), .depth = 8*1024};
+	
+	void* result = tina_call_on_stack(ctx.buffer, STACK_SIZE, deep_call, &ctx);
+	assert((uintptr_t)result == ctx.depth);
+	
+	tina* coro = tina_init(NULL, 64*1024, coro_body, &ctx);
+	result = tina_resume(coro, NULL);
+	assert((uintptr_t)result == ctx.depth);
+	tina_resume(coro, NULL);
+	assert(coro->completed);
+	
+	free(coro->buffer);
+	free(ctx.buffer);
+	puts("test_call_on_stack() success");
+	return EXIT_SUCCESS;
+}
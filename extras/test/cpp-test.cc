@@ -1,6 +1,10 @@
 // SPDX-License-Identifier: MIT
 // Copyright (c) 2026 Scott Lembcke and Howling Moon Software
 
+#include <cassert>
+#include <cstdio>
+#include <memory>
+
 #include "common/libs/tinycthread.h"
 
 #define TINA_IMPLEMENTATION
@@ -9,6 +13,175 @@
 #define TINA_JOBS_IMPLEMENTATION
 #include "tina_jobs.h"
 
+#include "tina.hpp"
+#include "tina_jobs.hpp"
+
+static void test_coroutine(void){
+	int counter = 0;
+	tina_cpp::coroutine coro(64*1024, [&counter](tina* coro, void* value){
+		for(int i = 0; i < 3; i++){
+			counter++;
+			tina_yield(coro, nullptr);
+		}
+		return value;
+	});
+
+	coro.resume();
+	tina_cpp::coroutine moved = std::move(coro);
+	while(!moved.completed()) moved.resume();
+	assert(counter == 3);
+
+	// Exceptions thrown while copying the body pass through the constructor.
+	struct throwing_body {
+		throwing_body() = default;
+		throwing_body(const throwing_body&){throw 42;}
+		void operator()(tina*, void*){}
+	} body;
+	bool threw = false;
+	try {tina_cpp::coroutine failed(64*1024, body);} catch(int){threw = true;}
+	assert(threw);
+
+	puts("test_coroutine() success");
+}
+
+static void test_spawn(void){
+	tina_cpp::scheduler sched(64, 1, 4, 64*1024);
+	tina_group group = {};
+
+	// Small trivial captures are stored inline in the job description.
+	int inline_count = 0;
+	for(int i = 0; i < 10; i++) sched.spawn(0, [&inline_count](tina_job* job){inline_count++;}, &group);
+
+	// Large or move only captures go in the closure arena.
+	int pooled_sum = 0;
+	for(int i = 0; i < 10; i++){
+		auto value = std::make_unique<int>(i);
+		sched.spawn(0, [&pooled_sum, value = std::move(value)](tina_job* job){pooled_sum += *value;}, &group);
+	}
+
+	sched.run(0, TINA_RUN_FLUSH);
+	assert(group._count == 0);
+	assert(inline_count == 10);
+	assert(pooled_sum == 45);
+
+	puts("test_spawn() success");
+}
+
+#if __cpp_impl_coroutine
+enum {QUEUE_A, QUEUE_B, _QUEUE_COUNT};
+
+static tina_cpp::detached awaitable_body(tina_scheduler* sched, tina_group* done, int* counter){
+	tina_job* job = co_await tina_cpp::switch_to(sched, QUEUE_B);
+	assert(tina_job_get_description(job)->queue_idx == QUEUE_B);
+
+	tina_group group = {};
+	for(int i = 0; i < 8; i++) tina_scheduler_enqueue(sched, [](tina_job* job){(*(int*)tina_job_get_description(job)->user_data)++;}, counter, 0, QUEUE_A, &group);
+
+	job = co_await tina_cpp::wait(sched, &group, QUEUE_A);
+	assert(tina_job_get_description(job)->queue_idx == QUEUE_A);
+	assert(*counter == 8);
+
+	tina_group_decrement(sched, done, 1);
+}
+
+static void test_awaitables(void){
+	tina_scheduler* sched = tina_scheduler_new(64, _QUEUE_COUNT, 4, 64*1024);
+	tina_group done = {};
+	tina_group_increment(sched, &done, 1, 0);
+
+	int counter = 0;
+	awaitable_body(sched, &done, &counter);
+	// Nothing runs until the queues are flushed.
+	assert(counter == 0);
+
+	tina_scheduler_run(sched, QUEUE_B, TINA_RUN_FLUSH);
+	tina_scheduler_run(sched, QUEUE_A, TINA_RUN_FLUSH);
+	assert(done._count == 0);
+
+	tina_scheduler_free(sched);
+	puts("test_awaitables() success");
+}
+#endif
+
+struct flag_receiver {
+	int* flag;
+	void set_value() && noexcept {
+		assert(tina_cpp::jobs_scheduler::current_job());
+		(*flag)++;
+	}
+	template<typename Error> void set_error(Error&&) && noexcept {assert(false);}
+	void set_stopped() && noexcept {assert(false);}
+};
+
+// Receives any values and hands them to a callback.
+template<typename Func>
+struct value_receiver {
+	Func func;
+	template<typename... Values> void set_value(Values&&... values) && noexcept {
+		assert(tina_cpp::jobs_scheduler::current_job());
+		func(std::forward<Values>(values)...);
+	}
+	template<typename Error> void set_error(Error&&) && noexcept {assert(false);}
+	void set_stopped() && noexcept {assert(false);}
+};
+
+template<typename Func>
+static value_receiver<Func> receive(Func func){return {func};}
+
+static void test_senders(void){
+	tina_cpp::scheduler sched(256, 1, 4, 64*1024);
+	tina_cpp::jobs_scheduler jobs(sched, 0);
+	int done = 0;
+
+	auto schedule_op = jobs.schedule().connect(flag_receiver{&done});
+	schedule_op.start();
+	sched.run(0, TINA_RUN_FLUSH);
+	assert(done == 1);
+	
+	// The scheduler is discoverable from a sender's environment.
+	auto env = tina_cpp::exec::get_env(jobs.schedule() | tina_cpp::then([]{return 0;}));
+	assert(tina_cpp::exec::get_completion_scheduler<tina_cpp::exec::set_value_t>(env) == jobs);
+
+	int sum = 0;
+	auto bulk_op = tina_cpp::exec::connect(jobs.schedule() | tina_cpp::bulk(100, [&sum](unsigned idx){sum += idx;}), flag_receiver{&done});
+	tina_cpp::exec::start(bulk_op);
+	sched.run(0, TINA_RUN_FLUSH);
+	assert(sum == 4950 && done == 2);
+	
+	// Values flow through then() and bulk().
+	int result = 0;
+	int scaled[10] = {};
+	auto chain = jobs.schedule()
+		| tina_cpp::then([]{return 3;})
+		| tina_cpp::bulk(10, [&scaled](unsigned idx, int factor){scaled[idx] = factor*(int)idx;})
+		| tina_cpp::then([](int factor){return factor + 1;});
+	auto chain_op = std::move(chain).connect(receive([&result](int value){result = value;}));
+	chain_op.start();
+	sched.run(0, TINA_RUN_FLUSH);
+	assert(result == 4 && scaled[9] == 27);
+
+	int bulk_count = 0;
+	auto when_all_op = tina_cpp::when_all(
+		jobs.schedule() | tina_cpp::then([]{return 1;}),
+		jobs.schedule() | tina_cpp::bulk(10, [&bulk_count](unsigned idx){bulk_count++;}),
+		tina_cpp::when_all(jobs.schedule() | tina_cpp::then([]{return 2.0;}), jobs.schedule())
+	).connect(receive([&done](int a, double b){
+		assert(a == 1 && b == 2.0);
+		done++;
+	}));
+	when_all_op.start();
+	sched.run(0, TINA_RUN_FLUSH);
+	assert(bulk_count == 10 && done == 3);
+
+	puts("test_senders() success");
+}
+
 int main(void){
+	test_coroutine();
+	test_spawn();
+	test_senders();
+#if __cpp_impl_coroutine
+	test_awaitables();
+#endif
 	return 0;
 }
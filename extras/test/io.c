@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_io.h"
+
+#if defined(__linux__)
+
+#include <unistd.h>
+#include <sys/un.h>
+
+#define PIPE_COUNT 32
+#define MESSAGE_COUNT 100
+
+static tina_io* IO;
+
+typedef struct {
+	int fd;
+	uint64_t sum;
+} stream_context;
+
+static void* writer_body(tina* coro, void* value){
+	stream_context* ctx = coro->user_data;
+	for(uint64_t i = 0; i < MESSAGE_COUNT; i++){
+		ssize_t result = tina_io_write(IO, coro, ctx->fd, &i, sizeof(i));
+		assert(result == sizeof(i));
+	}
+	close(ctx->fd);
+	return NULL;
+}
+
+static void* reader_body(tina* coro, void* value){
+	stream_context* ctx = coro->user_data;
+	uint64_t message;
+	size_t filled = 0;
+	while(true){
+		ssize_t result = tina_io_read(IO, coro, ctx->fd, (uint8_t*)&message + filled, sizeof(message) - filled);
+		assert(result >= 0);
+		if(result == 0) break;
+
+		// Reads can be partial, so reassemble the messages.
+		filled += result;
+		if(filled == sizeof(message)){
+			ctx->sum += message;
+			filled = 0;
+		}
+	}
+	close(ctx->fd);
+	return NULL;
+}
+
+static void run_all(tina** coros, unsigned count){
+	for(unsigned i = 0; i < count; i++) tina_resume(coros[i], NULL);
+	while(tina_io_pending(IO)) tina_io_poll(IO, true);
+	for(unsigned i = 0; i < count; i++){
+		assert(coros[i]->completed);
+		free(coros[i]);
+	}
+}
+
+static void test_pipes(void){
+	stream_context readers[PIPE_COUNT], writers[PIPE_COUNT];
+	tina* coros[2*PIPE_COUNT];
+	for(unsigned i = 0; i < PIPE_COUNT; i++){
+		int fds[2];
+		int err = pipe(fds);
+		assert(!err);
+
+		readers[i] = (stream_context){.fd = fds[0]};
+		writers[i] = (stream_context){.fd = fds[1]};
+		// Start the readers first so they all have to wait.
+		coros[i] = tina_init(NULL, 64*1024, reader_body, &readers[i]);
+		coros[PIPE_COUNT + i] = tina_init(NULL, 64*1024, writer_body, &writers[i]);
+	}
+
+	run_all(coros, 2*PIPE_COUNT);
+	for(unsigned i = 0; i < PIPE_COUNT; i++) assert(readers[i].sum == MESSAGE_COUNT*(MESSAGE_COUNT - 1)/2);
+	puts("test_pipes() success");
+}
+
+static void* echo_server_body(tina* coro, void* value){
+	int listener = *(int*)coro->user_data;
+	for(int i = 0; i < 4; i++){
+		int fd = tina_io_accept(IO, coro, listener, NULL, NULL);
+		assert(fd >= 0);
+
+		char buffer[16];
+		ssize_t len = tina_io_read(IO, coro, fd, buffer, sizeof(buffer));
+		assert(len > 0);
+		ssize_t result = tina_io_write(IO, coro, fd, buffer, len);
+		assert(result == len);
+		close(fd);
+	}
+	return NULL;
+}
+
+static void* echo_client_body(tina* coro, void* value){
+	int fd = *(int*)coro->user_data;
+	ssize_t result = tina_io_write(IO, coro, fd, "hello", 5);
+	assert(result == 5);
+
+	char buffer[16] = {0};
+	result = tina_io_read(IO, coro, fd, buffer, sizeof(buffer));
+	assert(result == 5 && memcmp(buffer, "hello", 5) == 0);
+	close(fd);
+	return NULL;
+}
+
+static void test_accept(void){
+	// Use an abstract socket name so nothing touches the filesystem.
+	struct sockaddr_un addr = {.sun_family = AF_UNIX};
+	int name_len = snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1, "tina-io-test-%d", (int)getpid());
+	socklen_t addr_len = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + name_len);
+
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	int err = bind(listener, (struct sockaddr*)&addr, addr_len) || listen(listener, 4);
+	assert(!err);
+
+	int clients[4];
+	tina* coros[5];
+	coros[0] = tina_init(NULL, 64*1024, echo_server_body, &listener);
+	for(int i = 0; i < 4; i++){
+		clients[i] = socket(AF_UNIX, SOCK_STREAM, 0);
+		err = connect(clients[i], (struct sockaddr*)&addr, addr_len);
+		assert(!err);
+		coros[i + 1] = tina_init(NULL, 64*1024, echo_client_body, &clients[i]);
+	}
+
+	run_all(coros, 5);
+	close(listener);
+	puts("test_accept() success");
+}
+
+static uint8_t FIXED_BUFFER[2][4096];
+
+static void* fixed_body(tina* coro, void* value){
+	int* fds = coro->user_data;
+	memset(FIXED_BUFFER[0], 0xAB, sizeof(FIXED_BUFFER[0]));
+	ssize_t result = tina_io_write_fixed(IO, coro, fds[0], FIXED_BUFFER[0], sizeof(FIXED_BUFFER[0]), 0);
+	assert(result == sizeof(FIXED_BUFFER[0]));
+
+	size_t filled = 0;
+	while(filled < sizeof(FIXED_BUFFER[1])){
+		result = tina_io_read_fixed(IO, coro, fds[1], FIXED_BUFFER[1] + filled, sizeof(FIXED_BUFFER[1]) - filled, 1);
+		assert(result > 0);
+		filled += result;
+	}
+	assert(memcmp(FIXED_BUFFER[0], FIXED_BUFFER[1], sizeof(FIXED_BUFFER[0])) == 0);
+	return NULL;
+}
+
+static void test_fixed_buffers(void){
+	struct iovec iovecs[] = {
+		{.iov_base = FIXED_BUFFER[0], .iov_len = sizeof(FIXED_BUFFER[0])},
+		{.iov_base = FIXED_BUFFER[1], .iov_len = sizeof(FIXED_BUFFER[1])},
+	};
+	int err = tina_io_register_buffers(IO, iovecs, 2);
+	assert(!err);
+
+	int fds[2];
+	err = socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+	assert(!err);
+
+	tina* coro = tina_init(NULL, 64*1024, fixed_body, fds);
+	run_all(&coro, 1);
+	close(fds[0]);
+	close(fds[1]);
+	puts("test_fixed_buffers() success");
+}
+
+int main(void){
+	const tina_io_backend backends[] = {TINA_IO_BACKEND_AUTO, TINA_IO_BACKEND_EPOLL};
+	for(unsigned i = 0; i < 2; i++){
+		IO = tina_io_new(256, backends[i]);
+		assert(IO);
+		printf("Testing %s backend.\n", tina_io_get_backend(IO) == TINA_IO_BACKEND_URING ? "io_uring" : "epoll");
+
+		test_pipes();
+		test_accept();
+		test_fixed_buffers();
+		tina_io_free(IO);
+	}
+	
+	// Submissions outnumber a tiny ring, and completions overflow it, so it has to make room before queueing more.
+	IO = tina_io_new(4, TINA_IO_BACKEND_AUTO);
+	assert(IO);
+	test_pipes();
+	tina_io_free(IO);
+	return 0;
+}
+
+#else
+
+int main(void){
+	puts("tina_io is Linux only. Skipping.");
+	return 0;
+}
+
+#endif
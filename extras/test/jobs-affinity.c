@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+// Benchmark for wake affinity. Fork/join jobs keep a working set on their stack that they touch before and after waiting.
+// Compare cache misses and run time when woken jobs go to the shared queue, back to the worker they last ran on, or are handed off directly.
+// Cache misses are measured with perf counters on Linux when they are available.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#if defined(__linux__)
+	#include <unistd.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+#endif
+
+#define PARENT_COUNT 4000
+#define CHILD_COUNT 8
+#define WORKING_SET 16*1024
+
+static tina_scheduler* SCHED;
+
+static void child_job(tina_job* job){
+	uint64_t* sum = tina_job_get_description(job)->user_data;
+	for(unsigned i = 0; i < 1000; i++) sum[1 + tina_job_get_description(job)->user_idx] += i;
+}
+
+static void parent_job(tina_job* job){
+	uint8_t working_set[WORKING_SET];
+	memset(working_set, (int)tina_job_get_description(job)->user_idx, sizeof(working_set));
+	
+	uint64_t sums[1 + CHILD_COUNT] = {0};
+	for(unsigned round = 0; round < 4; round++){
+		tina_group group = {0};
+		tina_scheduler_enqueue_n(SCHED, child_job, sums, CHILD_COUNT, 0, &group);
+		tina_job_wait(job, &group, 0);
+		
+		// Touch the working set again after resuming.
+		for(unsigned i = 0; i < sizeof(working_set); i += 64) sums[0] += working_set[i]++;
+	}
+	assert(sums[0] > 0);
+}
+
+static int open_counter(void){
+#if defined(__linux__)
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.inherit = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	return -1;
+#endif
+}
+
+static void run_trial(const char* name, tina_affinity_mode mode){
+	tina_scheduler_queue_affinity(SCHED, 0, mode);
+	
+	// The counter is inherited by the worker threads, so open it before starting them.
+	int counter = open_counter();
+#if defined(__linux__)
+	if(counter >= 0) ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	
+	uint64_t start = tina_scheduler_now(SCHED);
+	common_start_worker_threads(0, SCHED, 0);
+	tina_group group = {0};
+	for(unsigned i = 0; i < PARENT_COUNT;){
+		// Keep a limited number of parents in flight so they don't all need fibers at once.
+		if(tina_scheduler_enqueue_batch(SCHED, &(tina_job_description){.func = parent_job, .user_idx = i, .queue_idx = 0}, 1, &group, 32)){
+			i++;
+		} else {
+			thrd_yield();
+		}
+	}
+	while(tina_group_increment(SCHED, &group, 0, 0), group._count) thrd_yield();
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	double elapsed = (double)(tina_scheduler_now(SCHED) - start)/1e6;
+	
+	uint64_t misses = 0;
+#if defined(__linux__)
+	if(counter >= 0){
+		ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+		if(read(counter, &misses, sizeof(misses)) != sizeof(misses)) misses = 0;
+		close(counter);
+	}
+#endif
+	
+	if(counter >= 0){
+		printf("%-8s %8.2f ms, %10llu cache misses\n", name, elapsed, (unsigned long long)misses);
+	} else {
+		printf("%-8s %8.2f ms, cache misses unavailable\n", name, elapsed);
+	}
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(1024, 1, 256, 64*1024);
+	run_trial("None", TINA_AFFINITY_NONE);
+	run_trial("Prefer", TINA_AFFINITY_PREFER);
+	run_trial("Strict", TINA_AFFINITY_STRICT);
+	
+	// The worker that finishes the last child resumes the parent directly.
+	tina_scheduler_queue_handoff(SCHED, 0, true);
+	run_trial("Handoff", TINA_AFFINITY_PREFER);
+	
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+// Benchmark for the latency of each priority level in a TINA_QUEUE_PRIORITY queue that is kept saturated.
+// Compare strict priority (effectively infinite aging) where the lowest levels starve, with aging where their wait is bounded.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define MS 1000000ull
+#define LEVELS 4
+#define JOB_COUNT 20000
+#define IN_FLIGHT 256
+
+typedef struct {
+	uint64_t enqueued, started;
+	unsigned level;
+} job_record;
+
+static tina_scheduler* SCHED;
+static job_record RECORDS[JOB_COUNT];
+static uint64_t LATENCIES[JOB_COUNT];
+
+static void work(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	job_record* record = (job_record*)desc->user_data + desc->user_idx;
+	record->started = tina_scheduler_now(SCHED);
+
+	// Simulate about 10us of work.
+	while(tina_scheduler_now(SCHED) < record->started + 10000){}
+}
+
+static int compare_u64(const void* a, const void* b){
+	uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+static void run_trial(const char* name, uint64_t aging){
+	tina_scheduler_queue_aging(SCHED, 0, aging);
+
+	// Keep the queue saturated by topping it up as jobs finish.
+	tina_group group = {0};
+	srand(0);
+	for(unsigned i = 0; i < JOB_COUNT;){
+		RECORDS[i] = (job_record){.enqueued = tina_scheduler_now(SCHED), .level = rand() % LEVELS};
+		tina_job_description desc = {.func = work, .user_data = RECORDS, .user_idx = i, .queue_idx = 0, .priority = RECORDS[i].level};
+		if(tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, IN_FLIGHT)){
+			i++;
+		} else {
+			thrd_yield();
+		}
+	}
+	while(tina_group_increment(SCHED, &group, 0, 0), group._count) thrd_yield();
+
+	printf("%s:\n", name);
+	for(unsigned level = 0; level < LEVELS; level++){
+		unsigned count = 0;
+		for(unsigned i = 0; i < JOB_COUNT; i++){
+			if(RECORDS[i].level == level) LATENCIES[count++] = RECORDS[i].started - RECORDS[i].enqueued;
+		}
+		qsort(LATENCIES, count, sizeof(*LATENCIES), compare_u64);
+
+		printf("	level %u: p50 %8.2f ms, p99 %8.2f ms, max %8.2f ms\n", level,
+			(double)LATENCIES[count/2]/MS, (double)LATENCIES[count*99/100]/MS, (double)LATENCIES[count - 1]/MS
+		);
+	}
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(1024, 1, 64, 64*1024);
+	tina_scheduler_queue_mode(SCHED, 0, TINA_QUEUE_PRIORITY);
+	common_start_worker_threads(2, SCHED, 0);
+
+	run_trial("Strict priority", 1000000*MS);
+	run_trial("Aging 1 ms", 1*MS);
+	run_trial("Aging 0 (FIFO)", 0);
+
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+
+#define US 1000ull
+#define MS 1000000ull
+
+static tina_scheduler* SCHED;
+
+// Spin for 'user_idx' ns.
+static void busy_job(tina_job* job){
+	uint64_t start = tina_scheduler_now(SCHED);
+	while(tina_scheduler_now(SCHED) < start + tina_job_get_description(job)->user_idx){}
+}
+
+static void fill(unsigned count, uint64_t duration){
+	for(unsigned i = 0; i < count; i++) tina_scheduler_enqueue(SCHED, busy_job, NULL, duration, 0, NULL);
+}
+
+static void test_job_limit(void){
+	fill(20, 0);
+	assert(tina_scheduler_run_budget(SCHED, 0, 0, 5) == 5);
+	assert(tina_scheduler_run_budget(SCHED, 0, 0, 5) == 5);
+	
+	// An empty queue returns early.
+	assert(tina_scheduler_run_budget(SCHED, 0, 0, 100) == 10);
+	assert(tina_scheduler_run_budget(SCHED, 0, 0, 100) == 0);
+	puts("test_job_limit() success");
+}
+
+static void test_deadline(void){
+	fill(100, 200*US);
+	
+	// At most 10 of the jobs fit, plus the one started right before the deadline. A loaded machine may run fewer.
+	// Don't assert on the elapsed time since a job can overrun the deadline by an arbitrary amount if the thread is descheduled.
+	uint64_t start = tina_scheduler_now(SCHED);
+	unsigned count = tina_scheduler_run_budget(SCHED, 0, start + 2*MS, 0);
+	uint64_t elapsed = tina_scheduler_now(SCHED) - start;
+	printf("Ran %u jobs in %.2f ms.\n", count, (double)elapsed/MS);
+	assert(count > 0 && count <= 11);
+	assert(elapsed >= 2*MS);
+	
+	// A deadline that already passed doesn't run anything, and the rest are still queued.
+	assert(tina_scheduler_run_budget(SCHED, 0, start, 0) == 0);
+	assert(tina_scheduler_run_budget(SCHED, 0, 0, 0) == 100 - count);
+	puts("test_deadline() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(256, 1, 16, 64*1024);
+	
+	test_job_limit();
+	test_deadline();
+	
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
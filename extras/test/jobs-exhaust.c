@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define JOB_COUNT 16
+#define FIBER_COUNT 2
+
+static tina_scheduler* SCHED;
+
+static void count_job(tina_job* job){
+	(*(unsigned*)tina_job_get_description(job)->user_data)++;
+}
+
+static void test_try_enqueue(void){
+	unsigned count = 0;
+	tina_job_description descs[2*JOB_COUNT];
+	for(unsigned i = 0; i < 2*JOB_COUNT; i++){
+		tina_job_description desc = {.func = count_job, .user_data = &count, .queue_idx = 0};
+		descs[i] = desc;
+	}
+
+	// Only as many jobs as the pool holds are added.
+	assert(tina_scheduler_try_enqueue_batch(SCHED, descs, 2*JOB_COUNT, NULL, 0) == JOB_COUNT);
+	assert(tina_scheduler_try_enqueue_batch(SCHED, descs, 1, NULL, 0) == 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(count == JOB_COUNT);
+
+	puts("test_try_enqueue() success");
+}
+
+static void yield_job(tina_job* job){
+	tina_job_yield(job);
+	count_job(job);
+}
+
+static void test_fiber_deferral(void){
+	// Many more jobs than fibers are suspended at once. The rest wait for a fiber instead of aborting.
+	unsigned count = 0;
+	tina_group group = {0};
+	tina_job_description desc = {.func = yield_job, .user_data = &count, .queue_idx = 0};
+	for(unsigned i = 0; i < 8*FIBER_COUNT; i++) tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(count == 8*FIBER_COUNT && group._count == 0);
+	
+	// Each job runs once up to the yield, and once more to finish. Deferring a job doesn't count as running it.
+	count = 0;
+	for(unsigned i = 0; i < 8*FIBER_COUNT; i++) tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, 0);
+	assert(tina_scheduler_run_budget(SCHED, 0, 0, 0) == 2*8*FIBER_COUNT);
+	assert(count == 8*FIBER_COUNT && group._count == 0);
+
+	puts("test_fiber_deferral() success");
+}
+
+typedef struct {
+	unsigned count;
+	tina_group group;
+} producer_ctx;
+
+static void producer(tina_job* job){
+	producer_ctx* ctx = tina_job_get_description(job)->user_data;
+
+	// Enqueue many more jobs than fit in the pool. The producer is parked whenever it runs out.
+	tina_job_description descs[100];
+	for(unsigned i = 0; i < 100; i++){
+		tina_job_description desc = {.func = count_job, .user_data = &ctx->count, .queue_idx = 0};
+		descs[i] = desc;
+	}
+	tina_job_enqueue_batch(job, descs, 100, &ctx->group);
+}
+
+static void test_job_enqueue(void){
+	producer_ctx ctx = {.count = 0, .group = {0}};
+	tina_scheduler_enqueue(SCHED, producer, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.count == 100 && ctx.group._count == 0);
+
+	// Again with workers racing to run the jobs. The group tracks the producer too, so it only drops to 0 when everything ran.
+	common_start_worker_threads(2, SCHED, 0);
+	tina_scheduler_enqueue(SCHED, producer, &ctx, 0, 0, &ctx.group);
+	while(tina_group_increment(SCHED, &ctx.group, 0, 0), ctx.group._count) thrd_yield();
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+
+	puts("test_job_enqueue() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(JOB_COUNT, 1, FIBER_COUNT, 64*1024);
+
+	test_try_enqueue();
+	test_fiber_deferral();
+	test_job_enqueue();
+
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
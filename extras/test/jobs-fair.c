@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+enum {
+	QUEUE_A,
+	QUEUE_B,
+	_QUEUE_COUNT,
+};
+
+#define US 1000ull
+#define MS 1000000ull
+
+static tina_scheduler* SCHED;
+static tina_queue_set* SET;
+
+static mtx_t LOCK;
+static uint64_t BUSY_TIME[_QUEUE_COUNT];
+
+// Spin for 'user_idx' ns, and track how much time each queue used.
+static void busy_job(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	uint64_t start = tina_scheduler_now(SCHED), now;
+	do {now = tina_scheduler_now(SCHED);} while(now < start + desc->user_idx);
+	
+	mtx_lock(&LOCK);
+	BUSY_TIME[desc->queue_idx] += now - start;
+	mtx_unlock(&LOCK);
+}
+
+static void fill(unsigned queue_idx, unsigned count, uint64_t duration){
+	for(unsigned i = 0; i < count; i++) tina_scheduler_enqueue(SCHED, busy_job, NULL, duration, queue_idx, NULL);
+}
+
+static double run_share(unsigned job_count){
+	BUSY_TIME[QUEUE_A] = BUSY_TIME[QUEUE_B] = 0;
+	for(unsigned i = 0; i < job_count; i++) tina_scheduler_run_set(SCHED, SET, TINA_RUN_SINGLE);
+	return (double)BUSY_TIME[QUEUE_A]/(double)BUSY_TIME[QUEUE_B];
+}
+
+static void test_weights(void){
+	fill(QUEUE_A, 1000, 20*US);
+	fill(QUEUE_B, 1000, 20*US);
+	
+	double ratio = run_share(400);
+	printf("3:1 weights, ratio %.2f\n", ratio);
+	assert(2.4 < ratio && ratio < 3.6);
+	
+	// Weights can be changed on the fly.
+	tina_scheduler_set_weight(SCHED, SET, QUEUE_B, 3);
+	ratio = run_share(400);
+	printf("3:3 weights, ratio %.2f\n", ratio);
+	assert(0.8 < ratio && ratio < 1.25);
+	
+	// Jobs of different lengths still share by time, not by count.
+	tina_scheduler_run_set(SCHED, SET, TINA_RUN_FLUSH);
+	fill(QUEUE_A, 1000, 10*US);
+	fill(QUEUE_B, 1000, 40*US);
+	ratio = run_share(400);
+	printf("3:3 weights with 1:4 job lengths, ratio %.2f\n", ratio);
+	assert(0.8 < ratio && ratio < 1.25);
+	
+	tina_scheduler_run_set(SCHED, SET, TINA_RUN_FLUSH);
+	tina_scheduler_set_weight(SCHED, SET, QUEUE_B, 1);
+	puts("test_weights() success");
+}
+
+static void test_idle_share(void){
+	// Queue A's share isn't wasted while it's idle, and it doesn't bank it for later either.
+	fill(QUEUE_B, 200, 20*US);
+	BUSY_TIME[QUEUE_B] = 0;
+	tina_scheduler_run_set(SCHED, SET, TINA_RUN_FLUSH);
+	assert(BUSY_TIME[QUEUE_B] >= 200*20*US);
+	
+	fill(QUEUE_A, 1000, 20*US);
+	fill(QUEUE_B, 1000, 20*US);
+	double ratio = run_share(400);
+	printf("3:1 weights after idling, ratio %.2f\n", ratio);
+	assert(2.4 < ratio && ratio < 3.6);
+	
+	tina_scheduler_run_set(SCHED, SET, TINA_RUN_FLUSH);
+	puts("test_idle_share() success");
+}
+
+static int worker_body(void* data){
+	tina_scheduler_run_set(SCHED, SET, TINA_RUN_LOOP);
+	return 0;
+}
+
+static void test_workers(void){
+	thrd_t workers[2];
+	for(unsigned i = 0; i < 2; i++) thrd_create(&workers[i], worker_body, NULL);
+	
+	// Let the workers go idle, then make sure enqueues wake them up.
+	thrd_sleep(&(struct timespec){.tv_nsec = 10*MS}, NULL);
+	tina_group group = {0};
+	for(unsigned i = 0; i < 100; i++) tina_scheduler_enqueue(SCHED, busy_job, NULL, 10*US, i & 1, &group);
+	while(tina_group_increment(SCHED, &group, 0, 0), group._count) thrd_yield();
+	
+	tina_scheduler_interrupt_set(SCHED, SET);
+	for(unsigned i = 0; i < 2; i++) thrd_join(workers[i], NULL);
+	puts("test_workers() success");
+}
+
+int main(int argc, const char *argv[]){
+	mtx_init(&LOCK, mtx_plain);
+	SCHED = tina_scheduler_new(4096, _QUEUE_COUNT, 16, 64*1024);
+	
+	const unsigned queues[] = {QUEUE_A, QUEUE_B}, weights[] = {3, 1};
+	SET = tina_queue_set_new(SCHED, queues, weights, 2);
+	
+	test_weights();
+	test_idle_share();
+	test_workers();
+	
+	tina_queue_set_free(SCHED, SET);
+	tina_scheduler_free(SCHED);
+	mtx_destroy(&LOCK);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define JOB_COUNT 16
+#define FIBER_COUNT 2
+#define MAX_JOBS 256
+#define MAX_FIBERS 16
+
+static tina_scheduler* SCHED;
+
+static void yield_job(tina_job* job){
+	tina_job_yield(job);
+	tina_group_increment(SCHED, (tina_group*)tina_job_get_description(job)->user_data, 1, 0);
+}
+
+static unsigned count_free_jobs(void){
+	// Fill the pool without growing it, then flush the jobs again.
+	tina_group done = {0};
+	tina_job_description descs[MAX_JOBS];
+	for(unsigned i = 0; i < MAX_JOBS; i++){
+		tina_job_description desc = {.func = yield_job, .user_data = &done, .queue_idx = 0};
+		descs[i] = desc;
+	}
+	unsigned count = tina_scheduler_try_enqueue_batch(SCHED, descs, MAX_JOBS, NULL, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	return count;
+}
+
+static void test_grow(void){
+	tina_scheduler_growth(SCHED, MAX_JOBS, MAX_FIBERS, 0);
+
+	// Many more jobs than the initial pools, and they all suspend at once.
+	tina_group done = {0};
+	tina_job_description desc = {.func = yield_job, .user_data = &done, .queue_idx = 0};
+	for(unsigned i = 0; i < 200; i++) tina_scheduler_enqueue_batch(SCHED, &desc, 1, NULL, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(done._count == 200);
+
+	// It shrinks back to the initial size once it's idle.
+	tina_scheduler_growth(SCHED, 0, 0, 0);
+	assert(count_free_jobs() == JOB_COUNT);
+
+	puts("test_grow() success");
+}
+
+static void test_limit(void){
+	tina_scheduler_growth(SCHED, 3*JOB_COUNT, MAX_FIBERS, 0);
+	assert(count_free_jobs() == 3*JOB_COUNT);
+
+	// Jobs keep their address across growth while they wait in a queue.
+	tina_scheduler_growth(SCHED, MAX_JOBS, MAX_FIBERS, 1000000000);
+	tina_group done = {0};
+	tina_job_description desc = {.func = yield_job, .user_data = &done, .queue_idx = 0};
+	for(unsigned i = 0; i < 8; i++) tina_scheduler_enqueue_batch(SCHED, &desc, 1, NULL, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_SINGLE);
+	for(unsigned i = 0; i < 100; i++) tina_scheduler_enqueue_batch(SCHED, &desc, 1, NULL, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(done._count == 108);
+
+	// It didn't shrink because of the delay. It grew in chunks of the initial size.
+	tina_scheduler_growth(SCHED, 0, 0, 0);
+	assert(count_free_jobs() == 7*JOB_COUNT);
+
+	puts("test_limit() success");
+}
+
+static void test_threaded(void){
+	tina_scheduler_growth(SCHED, MAX_JOBS, MAX_FIBERS, 0);
+	common_start_worker_threads(2, SCHED, 0);
+
+	for(unsigned round = 0; round < 16; round++){
+		tina_group group = {0}, done = {0};
+		tina_job_description desc = {.func = yield_job, .user_data = &done, .queue_idx = 0};
+		for(unsigned i = 0; i < 100; i++) tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, 0);
+		while(tina_group_increment(SCHED, &group, 0, 0), group._count) thrd_yield();
+		assert(done._count == 100);
+	}
+
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	puts("test_threaded() success");
+}
+
+static void sleep_job(tina_job* job){
+	tina_job_sleep(job, 300000000);
+	tina_group_increment(SCHED, (tina_group*)tina_job_get_description(job)->user_data, 1, 0);
+}
+
+static void test_idle_shrink(void){
+	tina_scheduler_growth(SCHED, MAX_JOBS, MAX_FIBERS, 20000000);
+	common_start_worker_threads(1, SCHED, 0);
+
+	// A long running job holds on to a job from the initial pool while the pools grow around it.
+	tina_group group = {0}, done = {0};
+	tina_job_description desc = {.func = sleep_job, .user_data = &done, .queue_idx = 0};
+	tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, 0);
+	desc.func = yield_job;
+	for(unsigned i = 0; i < 100; i++) tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, 0);
+	while(tina_group_increment(SCHED, &done, 0, 0), done._count < 100) thrd_yield();
+
+	// The worker goes idle, and shrinks the pools once the delay passes even though no other job finished.
+	struct timespec delay = {.tv_sec = 0, .tv_nsec = 100000000};
+	thrd_sleep(&delay, NULL);
+	assert(done._count == 100);
+	tina_scheduler_growth(SCHED, 0, 0, 0);
+	tina_job_description descs[MAX_JOBS];
+	for(unsigned i = 0; i < MAX_JOBS; i++) descs[i] = desc;
+	assert(tina_scheduler_try_enqueue_batch(SCHED, descs, MAX_JOBS, &group, 0) == JOB_COUNT - 1);
+
+	while(tina_group_increment(SCHED, &group, 0, 0), group._count) thrd_yield();
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	puts("test_idle_shrink() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(JOB_COUNT, 1, FIBER_COUNT, 64*1024);
+
+	test_grow();
+	test_limit();
+	test_threaded();
+	test_idle_shrink();
+
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
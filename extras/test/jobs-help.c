@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define TREE_DEPTH 6
+#define LEAF_COUNT (1 << TREE_DEPTH)
+
+static tina_scheduler* SCHED;
+
+// Binary fork/join tree.
+static void tree_node(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	unsigned* leaves = desc->user_data;
+	unsigned depth = (unsigned)desc->user_idx;
+
+	if(depth == TREE_DEPTH){
+		(*leaves)++;
+		return;
+	}
+
+	tina_group group = {0};
+	tina_scheduler_enqueue(SCHED, tree_node, leaves, depth + 1, desc->queue_idx, &group);
+	tina_scheduler_enqueue(SCHED, tree_node, leaves, depth + 1, desc->queue_idx, &group);
+	assert(tina_job_wait(job, &group, 0) == 0);
+}
+
+static void test_tree(unsigned help_depth){
+	tina_scheduler_queue_help(SCHED, 0, help_depth);
+	unsigned leaves = 0;
+	tina_scheduler_enqueue(SCHED, tree_node, &leaves, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(leaves == LEAF_COUNT);
+}
+
+static void suspender(tina_job* job){
+	if(tina_job_get_description(job)->user_idx){
+		tina_job_sleep(job, 1000000);
+	} else {
+		tina_job_yield(job);
+		tina_job_yield(job);
+	}
+}
+
+static void suspend_waiter(tina_job* job){
+	// The nested job suspends the whole fiber it's borrowing. The waiter continues once it's resumed and finishes.
+	const tina_job_description* desc = tina_job_get_description(job);
+	tina_group group = {0};
+	tina_scheduler_enqueue(SCHED, suspender, NULL, desc->user_idx, 0, &group);
+	assert(tina_job_wait(job, &group, 0) == 0);
+	*(bool*)desc->user_data = true;
+}
+
+static void test_nested_suspend(bool sleep){
+	tina_scheduler_queue_help(SCHED, 0, 4);
+	bool done = false;
+	tina_scheduler_enqueue(SCHED, suspend_waiter, &done, sleep, 0, NULL);
+	while(!done) tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+}
+
+typedef struct {
+	tina_group group;
+	// Only used as a thread safe counter.
+	tina_group leaves;
+} threaded_ctx;
+
+static void threaded_node(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	threaded_ctx* ctx = desc->user_data;
+	unsigned depth = (unsigned)desc->user_idx;
+
+	if(depth == TREE_DEPTH){
+		tina_group_increment(SCHED, &ctx->leaves, 1, 0);
+		return;
+	}
+
+	tina_group group = {0};
+	tina_scheduler_enqueue(SCHED, threaded_node, ctx, depth + 1, 0, &group);
+	tina_scheduler_enqueue(SCHED, threaded_node, ctx, depth + 1, 0, &group);
+	tina_job_wait(job, &group, 0);
+}
+
+static void test_threaded(void){
+	// Workers race the waiters for the children, so some get helped and some get stolen.
+	tina_scheduler_queue_help(SCHED, 0, 3);
+	common_start_worker_threads(2, SCHED, 0);
+
+	for(unsigned i = 0; i < 32; i++){
+		threaded_ctx ctx = {.group = {0}, .leaves = {0}};
+		tina_scheduler_enqueue(SCHED, threaded_node, &ctx, 0, 0, &ctx.group);
+		while(tina_group_increment(SCHED, &ctx.group, 0, 0), ctx.group._count) thrd_yield();
+		assert(ctx.leaves._count == LEAF_COUNT);
+	}
+
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+}
+
+int main(int argc, const char *argv[]){
+	// Far fewer fibers than the tree has waiting jobs.
+	SCHED = tina_scheduler_new(1024, 1, 8, 64*1024);
+
+	test_tree(TREE_DEPTH);
+	puts("test_tree() success");
+	test_tree(TREE_DEPTH - 2);
+	puts("test_tree() with limited depth success");
+	test_nested_suspend(false);
+	puts("test_nested_suspend() yield success");
+	test_nested_suspend(true);
+	puts("test_nested_suspend() sleep success");
+	test_threaded();
+	puts("test_threaded() success");
+
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
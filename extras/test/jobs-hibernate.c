@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define MS 1000000ull
+#define FIBER_COUNT 4
+#define WAITER_COUNT 256
+
+static tina_scheduler* SCHED;
+// Groups can't live on the stack of a job that might be hibernated.
+static tina_group GROUPS[WAITER_COUNT];
+static tina_group DONE;
+
+static void waiter(tina_job* job){
+	unsigned idx = (unsigned)tina_job_get_description(job)->user_idx;
+
+	// Fill some stack with a pattern, and check it survives hibernation.
+	uint8_t pattern[4096];
+	memset(pattern, idx, sizeof(pattern));
+	tina_job_wait(job, &GROUPS[idx], 0);
+	for(unsigned i = 0; i < sizeof(pattern); i++) assert(pattern[i] == (uint8_t)idx);
+
+	// Yield too so the fiber might be taken while the job is in the queue.
+	tina_job_yield(job);
+	for(unsigned i = 0; i < sizeof(pattern); i++) assert(pattern[i] == (uint8_t)idx);
+}
+
+static void release(tina_job* job){
+	tina_group_decrement(SCHED, &GROUPS[tina_job_get_description(job)->user_idx], 1);
+}
+
+static void start_waiters(void){
+	for(unsigned i = 0; i < WAITER_COUNT; i++){
+		tina_group_increment(SCHED, &GROUPS[i], 1, 0);
+		tina_scheduler_enqueue(SCHED, waiter, NULL, i, 0, &DONE);
+	}
+}
+
+static void test_reserve(void){
+	// Many more jobs wait at once than there are fibers.
+	start_waiters();
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(DONE._count == WAITER_COUNT);
+
+	// Wake them in a scrambled order so they fight over their fibers.
+	for(unsigned i = 0; i < WAITER_COUNT; i++) tina_group_decrement(SCHED, &GROUPS[(i*97) % WAITER_COUNT], 1);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(DONE._count == 0);
+
+	puts("test_reserve() success");
+}
+
+static void test_threaded(void){
+	common_start_worker_threads(2, SCHED, 0);
+
+	for(unsigned round = 0; round < 8; round++){
+		start_waiters();
+		for(unsigned i = 0; i < WAITER_COUNT; i++) tina_scheduler_enqueue(SCHED, release, NULL, (i*97 + round) % WAITER_COUNT, 0, NULL);
+		while(tina_group_increment(SCHED, &DONE, 0, 0), DONE._count) thrd_yield();
+	}
+
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	puts("test_threaded() success");
+}
+
+static tina_scheduler* TINY;
+
+static void tiny_waiter(tina_job* job){
+	unsigned idx = (unsigned)tina_job_get_description(job)->user_idx;
+	uint8_t pattern[4096];
+	memset(pattern, idx, sizeof(pattern));
+	tina_job_wait(job, &GROUPS[idx], 0);
+	for(unsigned i = 0; i < sizeof(pattern); i++) assert(pattern[i] == (uint8_t)idx);
+}
+
+static void tiny_release(tina_job* job){
+	tina_group_decrement(TINY, &GROUPS[tina_job_get_description(job)->user_idx], 1);
+}
+
+#define PRODUCER_COUNT 3
+#define PRODUCER_RANGE (WAITER_COUNT/PRODUCER_COUNT)
+// Waiters released per producer lag behind by this many, which must leave room in the pool for the other producers' waiters.
+#define RELEASE_LAG 2
+
+static void producer(tina_job* job){
+	// Producers fill the job pool and get parked. Later ones start on fibers that are the home of hibernated waiters.
+	// Each waiter is released a few waiters later so they pile up waiting.
+	unsigned base = (unsigned)tina_job_get_description(job)->user_idx;
+	for(unsigned i = 0; i < PRODUCER_RANGE + RELEASE_LAG; i++){
+		if(i < PRODUCER_RANGE){
+			tina_group_increment(TINY, &GROUPS[base + i], 1, 0);
+			tina_job_description desc = {.func = tiny_waiter, .user_idx = base + i, .queue_idx = 0};
+			tina_job_enqueue_batch(job, &desc, 1, &DONE);
+		}
+		if(i >= RELEASE_LAG){
+			tina_job_description desc = {.func = tiny_release, .user_idx = base + i - RELEASE_LAG, .queue_idx = 0};
+			tina_job_enqueue_batch(job, &desc, 1, &DONE);
+		}
+	}
+}
+
+static void test_full_pool(void){
+	// Tiny job pool with few fibers, so producers are parked for capacity while holding fibers that waiters need.
+	TINY = tina_scheduler_new(16, 1, 4, 64*1024);
+	tina_scheduler_hibernation(TINY, 1, 0);
+	common_start_worker_threads(2, TINY, 0);
+
+	for(unsigned round = 0; round < 16; round++){
+		// Enqueue them at once since the first one will fill the pool.
+		tina_job_description descs[PRODUCER_COUNT];
+		for(unsigned i = 0; i < PRODUCER_COUNT; i++){
+			tina_job_description desc = {.func = producer, .user_idx = i*PRODUCER_RANGE, .queue_idx = 0};
+			descs[i] = desc;
+		}
+		tina_scheduler_enqueue_batch(TINY, descs, PRODUCER_COUNT, &DONE, 0);
+		while(tina_group_increment(TINY, &DONE, 0, 0), DONE._count) thrd_yield();
+	}
+
+	tina_scheduler_interrupt(TINY, 0);
+	common_destroy_worker_threads();
+	tina_scheduler_free(TINY);
+	puts("test_full_pool() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(1024, 1, FIBER_COUNT, 64*1024);
+	tina_scheduler_hibernation(SCHED, 1, 100*MS);
+
+	test_reserve();
+	test_threaded();
+	test_full_pool();
+
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "tina_io.h"
+#include "common/common.h"
+
+#if defined(__linux__)
+
+#define BLOCK_COUNT 64
+#define BLOCK_SIZE 4096
+
+static tina_scheduler* SCHED;
+static tina_jobs_io* IO;
+static int FD;
+static volatile bool DONE;
+
+static void block_job(tina_job* job){
+	unsigned idx = (unsigned)tina_job_get_description(job)->user_idx;
+	uint64_t offset = (uint64_t)idx*BLOCK_SIZE;
+
+	uint8_t block[BLOCK_SIZE], readback[BLOCK_SIZE];
+	memset(block, idx, sizeof(block));
+	ssize_t result = tina_job_write(job, FD, block, sizeof(block), offset);
+	assert(result == BLOCK_SIZE);
+
+	result = tina_job_read(job, FD, readback, sizeof(readback), offset);
+	assert(result == BLOCK_SIZE);
+	assert(memcmp(block, readback, sizeof(block)) == 0);
+
+	// Errors come back as negative errno values.
+	result = tina_job_read(job, -1, readback, sizeof(readback), 0);
+	assert(result == -EBADF);
+}
+
+static void done_job(tina_job* job){
+	int result = tina_job_fsync(job, FD);
+	assert(result == 0);
+
+	DONE = true;
+	if(IO) tina_jobs_io_interrupt(IO);
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(256, 1, 128, 64*1024);
+	IO = tina_jobs_io_new(SCHED, 64);
+	printf("Testing with %s.\n", IO ? "io_uring" : "blocking syscalls");
+
+	FILE* file = tmpfile();
+	FD = fileno(file);
+	common_start_worker_threads(2, SCHED, 0);
+
+	tina_group group = {0};
+	tina_job_description desc = {.func = done_job, .queue_idx = 0};
+	tina_group_increment(SCHED, &group, 1, 0);
+	tina_scheduler_enqueue_after(SCHED, &desc, NULL, &group, 0);
+	tina_scheduler_enqueue_n(SCHED, block_job, NULL, BLOCK_COUNT, 0, &group);
+	tina_group_decrement(SCHED, &group, 1);
+
+	// This thread is the only one that waits in the kernel, the workers just queue requests.
+	unsigned completed = 0;
+	while(!DONE){
+		if(IO){
+			completed += tina_jobs_io_poll(IO, true);
+		} else {
+			thrd_yield();
+		}
+	}
+	assert(!IO || completed >= 3*BLOCK_COUNT + 1);
+
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	if(IO) tina_jobs_io_free(IO);
+	tina_scheduler_free(SCHED);
+	fclose(file);
+
+	printf("jobs-io success: %u requests completed.\n", completed);
+	return EXIT_SUCCESS;
+}
+
+#else
+
+int main(void){
+	puts("tina_jobs_io is Linux only. Skipping.");
+	return 0;
+}
+
+#endif
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+
+#define MS 1000000ull
+#define JOB_COUNT 64
+
+static tina_scheduler* SCHED;
+
+typedef struct {
+	const tina_job_description* order[JOB_COUNT];
+	unsigned count;
+} order_ctx;
+
+static void record_order(tina_job* job){
+	order_ctx* ctx = tina_job_get_description(job)->user_data;
+	// Descriptions are copied into the job, so record the index instead.
+	ctx->order[ctx->count++] = (const tina_job_description*)tina_job_get_description(job)->user_idx;
+}
+
+static void test_deadline_order(void){
+	tina_scheduler_queue_mode(SCHED, 0, TINA_QUEUE_DEADLINE);
+	order_ctx ctx = {0};
+
+	tina_job_description descs[JOB_COUNT];
+	uint64_t now = tina_scheduler_now(SCHED);
+	for(unsigned i = 0; i < JOB_COUNT; i++){
+		// Every 8th job has no deadline, and there are plenty of duplicates to check that ties stay FIFO.
+		uint64_t deadline = (i % 8 == 7) ? 0 : now + (uint64_t)(rand() % 8)*MS;
+		tina_job_description desc = {.func = record_order, .user_data = &ctx, .user_idx = (uintptr_t)&descs[i], .queue_idx = 0, .deadline = deadline};
+		descs[i] = desc;
+	}
+	tina_scheduler_enqueue_batch(SCHED, descs, JOB_COUNT, NULL, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+
+	assert(ctx.count == JOB_COUNT);
+	for(unsigned i = 1; i < JOB_COUNT; i++){
+		const tina_job_description* a = ctx.order[i - 1];
+		const tina_job_description* b = ctx.order[i];
+		uint64_t key_a = a->deadline ? a->deadline : UINT64_MAX;
+		uint64_t key_b = b->deadline ? b->deadline : UINT64_MAX;
+		assert(key_a < key_b || (key_a == key_b && a < b));
+	}
+
+	tina_scheduler_queue_mode(SCHED, 0, TINA_QUEUE_FIFO);
+	tina_scheduler_queue_stats(SCHED, 0, true);
+	puts("test_deadline_order() success");
+}
+
+static void nop(tina_job* job){}
+
+static void test_missed_deadlines(void){
+	tina_scheduler_queue_mode(SCHED, 0, TINA_QUEUE_DEADLINE);
+
+	uint64_t now = tina_scheduler_now(SCHED);
+	for(unsigned i = 0; i < 10; i++){
+		// Make 3 of the jobs already late.
+		uint64_t deadline = i < 3 ? now - 5*MS : now + 1000*MS;
+		tina_job_description desc = {.func = nop, .queue_idx = 0, .deadline = deadline};
+		tina_scheduler_enqueue_batch(SCHED, &desc, 1, NULL, 0);
+	}
+	// Jobs without deadlines aren't counted.
+	tina_scheduler_enqueue(SCHED, nop, NULL, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+
+	tina_queue_stats stats = tina_scheduler_queue_stats(SCHED, 0, true);
+	assert(stats.completed == 10);
+	assert(stats.missed == 3);
+	assert(stats.max_lateness >= 5*MS);
+
+	stats = tina_scheduler_queue_stats(SCHED, 0, false);
+	assert(stats.completed == 0 && stats.missed == 0 && stats.max_lateness == 0);
+
+	tina_scheduler_queue_mode(SCHED, 0, TINA_QUEUE_FIFO);
+	puts("test_missed_deadlines() success");
+}
+
+static void test_priority_order(void){
+	tina_scheduler_queue_mode(SCHED, 0, TINA_QUEUE_PRIORITY);
+
+	// With a huge aging time it's strict priority, and FIFO within a level.
+	tina_scheduler_queue_aging(SCHED, 0, 1000000*MS);
+	order_ctx ctx = {0};
+	tina_job_description descs[JOB_COUNT];
+	for(unsigned i = 0; i < JOB_COUNT; i++){
+		tina_job_description desc = {.func = record_order, .user_data = &ctx, .user_idx = (uintptr_t)&descs[i], .queue_idx = 0, .priority = rand() % 4};
+		descs[i] = desc;
+	}
+	tina_scheduler_enqueue_batch(SCHED, descs, JOB_COUNT, NULL, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+
+	assert(ctx.count == JOB_COUNT);
+	for(unsigned i = 1; i < JOB_COUNT; i++){
+		const tina_job_description* a = ctx.order[i - 1];
+		const tina_job_description* b = ctx.order[i];
+		assert(a->priority < b->priority || (a->priority == b->priority && a < b));
+	}
+
+	// A low priority job that has waited long enough goes ahead of newer high priority jobs.
+	tina_scheduler_queue_aging(SCHED, 0, 1*MS);
+	ctx.count = 0;
+	descs[0] = (tina_job_description){.func = record_order, .user_data = &ctx, .user_idx = (uintptr_t)&descs[0], .queue_idx = 0, .priority = 2};
+	tina_scheduler_enqueue_batch(SCHED, &descs[0], 1, NULL, 0);
+	uint64_t start = tina_scheduler_now(SCHED);
+	while(tina_scheduler_now(SCHED) < start + 3*MS){}
+	descs[1] = (tina_job_description){.func = record_order, .user_data = &ctx, .user_idx = (uintptr_t)&descs[1], .queue_idx = 0, .priority = 0};
+	tina_scheduler_enqueue_batch(SCHED, &descs[1], 1, NULL, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.count == 2 && ctx.order[0] == &descs[0]);
+
+	tina_scheduler_queue_mode(SCHED, 0, TINA_QUEUE_FIFO);
+	puts("test_priority_order() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(256, 1, 16, 64*1024);
+
+	test_deadline_order();
+	test_missed_deadlines();
+	test_priority_order();
+
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define MS 1000000ull
+
+static tina_scheduler* SCHED;
+
+typedef struct {
+	unsigned order[64];
+	unsigned count;
+} order_ctx;
+
+static void record_order(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	order_ctx* ctx = desc->user_data;
+	ctx->order[ctx->count++] = (unsigned)desc->user_idx;
+}
+
+static void spawn_two(tina_job* job){
+	order_ctx* ctx = tina_job_get_description(job)->user_data;
+	tina_scheduler_enqueue(SCHED, record_order, ctx, 1, 0, NULL);
+	tina_scheduler_enqueue(SCHED, record_order, ctx, 2, 0, NULL);
+	record_order(job);
+}
+
+static void test_lifo(void){
+	// The most recently spawned job runs next, the one it kicked out of the slot goes to the back of the queue.
+	order_ctx ctx = {0};
+	tina_scheduler_enqueue(SCHED, spawn_two, &ctx, 0, 0, NULL);
+	tina_scheduler_enqueue(SCHED, record_order, &ctx, 3, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	
+	assert(ctx.count == 4);
+	assert(ctx.order[0] == 0 && ctx.order[1] == 2 && ctx.order[2] == 3 && ctx.order[3] == 1);
+	
+	// Jobs left in the slot go back to the queue when the worker stops.
+	ctx.count = 0;
+	tina_scheduler_enqueue(SCHED, spawn_two, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_SINGLE);
+	assert(ctx.count == 1);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.count == 3);
+	
+	puts("test_lifo() success");
+}
+
+static void chain_job(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	record_order(job);
+	if(desc->user_idx < 20) tina_scheduler_enqueue(SCHED, chain_job, desc->user_data, desc->user_idx + 1, 0, NULL);
+}
+
+static void test_fairness(void){
+	// A chain of jobs that each spawn the next one can't monopolize the worker.
+	order_ctx ctx = {0};
+	tina_scheduler_enqueue(SCHED, chain_job, &ctx, 0, 0, NULL);
+	tina_scheduler_enqueue(SCHED, record_order, &ctx, 100, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	
+	assert(ctx.count == 22);
+	unsigned position = 0;
+	while(ctx.order[position] != 100) position++;
+	assert(position <= 5);
+	
+	puts("test_fairness() success");
+}
+
+static void budget_job(tina_job* job){
+	// Jobs run by tina_scheduler_run_budget() don't have a worker, so they can't use the slot of the one running this job.
+	assert(tina_scheduler_run_budget(SCHED, 0, 0, 0) == 3);
+	record_order(job);
+}
+
+static void pending_job(tina_job* job){
+	// The child waits in this worker's slot instead of the queue, but it still counts as pending.
+	tina_scheduler_enqueue(SCHED, record_order, tina_job_get_description(job)->user_data, 1, 0, NULL);
+	assert(tina_job_yield_if_pending(job));
+	record_order(job);
+}
+
+static void test_nested(void){
+	order_ctx ctx = {0};
+	tina_scheduler_enqueue(SCHED, budget_job, &ctx, 3, 0, NULL);
+	tina_scheduler_enqueue(SCHED, spawn_two, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.count == 4 && ctx.order[3] == 3);
+	
+	ctx.count = 0;
+	tina_scheduler_enqueue(SCHED, pending_job, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.count == 2 && ctx.order[0] == 1 && ctx.order[1] == 0);
+	
+	puts("test_nested() success");
+}
+
+typedef struct {
+	volatile bool child_done;
+	bool stolen;
+} steal_ctx;
+
+static void child_job(tina_job* job){
+	steal_ctx* ctx = tina_job_get_description(job)->user_data;
+	ctx->child_done = true;
+}
+
+static void busy_parent_job(tina_job* job){
+	steal_ctx* ctx = tina_job_get_description(job)->user_data;
+	tina_scheduler_enqueue(SCHED, child_job, ctx, 0, 0, NULL);
+	
+	// Run long enough that an idle worker should steal the child from this worker's slot.
+	uint64_t start = tina_scheduler_now(SCHED);
+	while(!ctx->child_done && tina_scheduler_now(SCHED) < start + 1000*MS) thrd_yield();
+	ctx->stolen = ctx->child_done;
+}
+
+static void test_steal(void){
+	common_start_worker_threads(2, SCHED, 0);
+	
+	steal_ctx ctx = {0};
+	tina_group group = {0};
+	tina_scheduler_enqueue(SCHED, busy_parent_job, &ctx, 0, 0, &group);
+	while(tina_group_increment(SCHED, &group, 0, 0), group._count) thrd_yield();
+	assert(ctx.stolen);
+	
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	puts("test_steal() success");
+}
+
+static void same_thread_job(tina_job* job){
+	thrd_t thread = thrd_current();
+	for(unsigned round = 0; round < 4; round++){
+		tina_group group = {0};
+		tina_scheduler_enqueue_n(SCHED, child_job, tina_job_get_description(job)->user_data, 4, 0, &group);
+		tina_job_wait(job, &group, 0);
+		assert(thrd_equal(thread, thrd_current()));
+	}
+}
+
+static void test_affinity(void){
+	// With strict affinity, jobs always resume on the worker they waited on.
+	tina_scheduler_queue_runnext(SCHED, 0, 0);
+	tina_scheduler_queue_affinity(SCHED, 0, TINA_AFFINITY_STRICT);
+	common_start_worker_threads(4, SCHED, 0);
+	
+	steal_ctx ctx = {0};
+	tina_group group = {0};
+	tina_scheduler_enqueue_n(SCHED, same_thread_job, &ctx, 8, 0, &group);
+	while(tina_group_increment(SCHED, &group, 0, 0), group._count) thrd_yield();
+	
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	tina_scheduler_queue_affinity(SCHED, 0, TINA_AFFINITY_NONE);
+	puts("test_affinity() success");
+}
+
+static void fork_join_job(tina_job* job){
+	order_ctx* ctx = tina_job_get_description(job)->user_data;
+	tina_group group = {0};
+	tina_scheduler_enqueue(SCHED, record_order, ctx, 1, 0, &group);
+	for(unsigned i = 0; i < 3; i++) tina_scheduler_enqueue(SCHED, record_order, ctx, 2, 0, NULL);
+	tina_job_wait(job, &group, 0);
+	record_order(job);
+}
+
+static void test_handoff(void){
+	// Without a handoff, the parent resumes behind the other jobs in the queue.
+	order_ctx ctx = {0};
+	tina_scheduler_enqueue(SCHED, fork_join_job, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.count == 5 && ctx.order[0] == 1 && ctx.order[4] == 0);
+	
+	// With a handoff, it resumes as soon as the child finishes.
+	tina_scheduler_queue_handoff(SCHED, 0, true);
+	ctx.count = 0;
+	tina_scheduler_enqueue(SCHED, fork_join_job, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.count == 5 && ctx.order[0] == 1 && ctx.order[1] == 0);
+	
+	tina_scheduler_queue_handoff(SCHED, 0, false);
+	puts("test_handoff() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(256, 1, 16, 64*1024);
+	tina_scheduler_queue_runnext(SCHED, 0, 3);
+	
+	test_lifo();
+	test_fairness();
+	test_nested();
+	test_steal();
+	test_affinity();
+	test_handoff();
+	
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
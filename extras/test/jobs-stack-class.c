@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define SMALL_STACK (64*1024)
+#define BIG_STACK (1024*1024)
+#define BIG_FIBERS 2
+
+static tina_scheduler* SCHED;
+static uint8_t* BIG_BUFFER;
+static size_t BIG_BUFFER_SIZE;
+static unsigned BIG_CLASS;
+
+static bool on_big_stack(void* ptr){
+	return BIG_BUFFER <= (uint8_t*)ptr && (uint8_t*)ptr < BIG_BUFFER + BIG_BUFFER_SIZE;
+}
+
+static void small_job(tina_job* job){
+	// Small jobs may still run nested on a big stack when helping is enabled.
+	uint8_t local;
+	if(tina_job_get_description(job)->user_idx) assert(!on_big_stack(&local));
+	(*(unsigned*)tina_job_get_description(job)->user_data)++;
+}
+
+static void big_job(tina_job* job){
+	// Way more than fits on a small stack.
+	uint8_t buffer[256*1024];
+	memset(buffer, 0xAB, sizeof(buffer));
+	assert(on_big_stack(buffer));
+	tina_job_yield(job);
+	assert(buffer[0] == 0xAB && buffer[sizeof(buffer) - 1] == 0xAB);
+	(*(unsigned*)tina_job_get_description(job)->user_data)++;
+}
+
+static void test_description(void){
+	// More big jobs than big fibers, and they all yield at once.
+	unsigned small = 0, big = 0;
+	for(unsigned i = 0; i < 4*BIG_FIBERS; i++){
+		tina_job_description descs[] = {
+			{.func = big_job, .user_data = &big, .queue_idx = 0, .stack_class = BIG_CLASS},
+			{.func = small_job, .user_data = &small, .user_idx = 1, .queue_idx = 0},
+		};
+		tina_scheduler_enqueue_batch(SCHED, descs, 2, NULL, 0);
+	}
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(small == 4*BIG_FIBERS && big == 4*BIG_FIBERS);
+
+	puts("test_description() success");
+}
+
+static void test_queue_default(void){
+	tina_scheduler_queue_stack_class(SCHED, 1, BIG_CLASS);
+	unsigned count = 0;
+	tina_scheduler_enqueue(SCHED, big_job, &count, 0, 1, NULL);
+	tina_scheduler_run(SCHED, 1, TINA_RUN_FLUSH);
+	assert(count == 1);
+
+	puts("test_queue_default() success");
+}
+
+static void big_parent(tina_job* job){
+	unsigned* count = tina_job_get_description(job)->user_data;
+
+	// A big parent can help with it's small children, but a small parent has to wait for it's big ones.
+	tina_group group = {0};
+	tina_job_description descs[] = {
+		{.func = small_job, .user_data = count, .queue_idx = 0},
+		{.func = big_job, .user_data = count, .queue_idx = 0, .stack_class = BIG_CLASS},
+	};
+	tina_scheduler_enqueue_batch(SCHED, descs, 2, &group, 0);
+	tina_job_wait(job, &group, 0);
+}
+
+static void small_parent(tina_job* job){
+	unsigned* count = tina_job_get_description(job)->user_data;
+	tina_group group = {0};
+	tina_job_description desc = {.func = big_job, .user_data = count, .queue_idx = 0, .stack_class = BIG_CLASS};
+	tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, 0);
+	tina_job_wait(job, &group, 0);
+}
+
+static void test_help(void){
+	tina_scheduler_queue_help(SCHED, 0, 4);
+	unsigned count = 0;
+	tina_job_description descs[] = {
+		{.func = big_parent, .user_data = &count, .queue_idx = 0, .stack_class = BIG_CLASS},
+		{.func = small_parent, .user_data = &count, .queue_idx = 0},
+	};
+	tina_scheduler_enqueue_batch(SCHED, descs, 2, NULL, 0);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(count == 3);
+	tina_scheduler_queue_help(SCHED, 0, 0);
+
+	puts("test_help() success");
+}
+
+static void threaded_job(tina_job* job){
+	uint8_t buffer[256*1024];
+	memset(buffer, 0xAB, sizeof(buffer));
+	assert(on_big_stack(buffer));
+	tina_job_yield(job);
+	tina_group_increment(SCHED, (tina_group*)tina_job_get_description(job)->user_data, 1, 0);
+}
+
+static void test_threaded(void){
+	common_start_worker_threads(2, SCHED, 0);
+
+	for(unsigned round = 0; round < 16; round++){
+		tina_group group = {0}, done = {0};
+		for(unsigned i = 0; i < 16; i++){
+			tina_job_description desc = {.func = threaded_job, .user_data = &done, .queue_idx = 0, .stack_class = BIG_CLASS};
+			tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, 0);
+		}
+		while(tina_group_increment(SCHED, &group, 0, 0), group._count) thrd_yield();
+		assert(done._count == 16);
+	}
+
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	puts("test_threaded() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(256, 2, 16, SMALL_STACK);
+	BIG_BUFFER_SIZE = tina_stack_class_size(BIG_FIBERS, BIG_STACK);
+	BIG_BUFFER = malloc(BIG_BUFFER_SIZE);
+	BIG_CLASS = tina_scheduler_add_stack_class(SCHED, BIG_BUFFER, BIG_FIBERS, BIG_STACK);
+	assert(BIG_CLASS == 1);
+	// Unused, but freed along with the scheduler.
+	unsigned unused_class = tina_scheduler_new_stack_class(SCHED, 1, 64*1024);
+	assert(unused_class == 2);
+
+	test_description();
+	test_queue_default();
+	test_help();
+	test_threaded();
+
+	tina_scheduler_free(SCHED);
+	free(BIG_BUFFER);
+	return EXIT_SUCCESS;
+}
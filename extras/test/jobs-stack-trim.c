@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define FIBER_COUNT 8
+#define STACK_SIZE (1024*1024)
+#define DEEP_BYTES (512*1024)
+#define KEEP_FIBERS 2
+
+static tina_scheduler* SCHED;
+
+static void deep_job(tina_job* job){
+	// Touch a lot of stack, and yield so every fiber is in use at once.
+	volatile uint8_t buffer[DEEP_BYTES];
+	memset((void*)buffer, 0xAB, sizeof(buffer));
+	tina_job_yield(job);
+	assert(buffer[0] == 0xAB && buffer[sizeof(buffer) - 1] == 0xAB);
+	tina_group_increment(SCHED, (tina_group*)tina_job_get_description(job)->user_data, 1, 0);
+}
+
+static void run_spike(void){
+	tina_group done = {0};
+	for(unsigned i = 0; i < FIBER_COUNT; i++) tina_scheduler_enqueue(SCHED, deep_job, &done, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(done._count == FIBER_COUNT);
+}
+
+static void test_trim(void){
+	// Nothing is trimmed until it's enabled.
+	run_spike();
+	assert(tina_scheduler_trim_stacks(SCHED) == 0);
+	size_t resident = tina_scheduler_stack_resident(SCHED);
+	printf("resident after spike: %zu KB\n", resident/1024);
+
+	tina_scheduler_stack_trimming(SCHED, KEEP_FIBERS, 16*1024);
+	size_t released = tina_scheduler_trim_stacks(SCHED);
+	size_t trimmed = tina_scheduler_stack_resident(SCHED);
+	printf("released: %zu KB, resident after trim: %zu KB\n", released/1024, trimmed/1024);
+#if defined(__linux__)
+	assert(resident >= FIBER_COUNT*DEEP_BYTES);
+	assert(released >= (FIBER_COUNT - KEEP_FIBERS)*(DEEP_BYTES - 32*1024));
+	assert(trimmed <= resident - released + (FIBER_COUNT - KEEP_FIBERS)*4096);
+#endif
+
+	// Fibers are only trimmed once until they run again.
+	assert(tina_scheduler_trim_stacks(SCHED) == 0);
+
+	// Trimmed fibers still work, and they can be trimmed again after they ran.
+	run_spike();
+#if defined(__linux__)
+	assert(tina_scheduler_stack_resident(SCHED) >= FIBER_COUNT*DEEP_BYTES);
+	// How much is resident depends on how the compiler laid out the frames, so only check a bound.
+	size_t again = tina_scheduler_trim_stacks(SCHED);
+	assert(again > 0 && again <= resident);
+#endif
+
+	puts("test_trim() success");
+}
+
+static void test_threaded(void){
+	common_start_worker_threads(2, SCHED, 0);
+
+	// Trim while the workers are taking and returning fibers.
+	for(unsigned round = 0; round < 16; round++){
+		tina_group group = {0}, done = {0};
+		tina_job_description desc = {.func = deep_job, .user_data = &done, .queue_idx = 0};
+		for(unsigned i = 0; i < FIBER_COUNT; i++) tina_scheduler_enqueue_batch(SCHED, &desc, 1, &group, 0);
+		while(tina_group_increment(SCHED, &group, 0, 0), group._count){
+			tina_scheduler_trim_stacks(SCHED);
+			thrd_yield();
+		}
+		assert(done._count == FIBER_COUNT);
+	}
+
+	tina_scheduler_interrupt(SCHED, 0);
+	common_destroy_worker_threads();
+	puts("test_threaded() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(64, 1, FIBER_COUNT, STACK_SIZE);
+
+	test_trim();
+	test_threaded();
+
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+enum {
+	QUEUE_GFX,
+	QUEUE_WORK,
+	QUEUE_IO,
+	_QUEUE_COUNT,
+};
+
+#define MS 1000000ull
+
+static tina_scheduler* SCHED;
+static tina_subscription* SUB_GFX;
+static tina_subscription* SUB_IO;
+
+typedef struct {
+	unsigned order[16];
+	unsigned count;
+} order_ctx;
+
+static void record_queue(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	order_ctx* ctx = desc->user_data;
+	ctx->order[ctx->count++] = desc->queue_idx;
+}
+
+static void test_ordering(void){
+	order_ctx ctx = {0};
+	const unsigned queues[] = {QUEUE_WORK, QUEUE_IO, QUEUE_GFX, QUEUE_WORK, QUEUE_IO, QUEUE_GFX};
+	for(unsigned i = 0; i < 6; i++) tina_scheduler_enqueue(SCHED, record_queue, &ctx, 0, queues[i], NULL);
+	
+	// The graphics thread prefers it's own queue, but helps with general work.
+	tina_scheduler_run_subscription(SCHED, SUB_GFX, TINA_RUN_FLUSH);
+	assert(ctx.count == 4);
+	assert(ctx.order[0] == QUEUE_GFX && ctx.order[1] == QUEUE_GFX);
+	assert(ctx.order[2] == QUEUE_WORK && ctx.order[3] == QUEUE_WORK);
+	
+	// Only the I/O jobs are left.
+	tina_scheduler_run_subscription(SCHED, SUB_IO, TINA_RUN_FLUSH);
+	assert(ctx.count == 6 && ctx.order[4] == QUEUE_IO && ctx.order[5] == QUEUE_IO);
+	
+	puts("test_ordering() success");
+}
+
+static thrd_t GFX_THREAD, IO_THREAD;
+
+static int gfx_body(void* data){
+	tina_scheduler_run_subscription(SCHED, SUB_GFX, TINA_RUN_LOOP);
+	return 0;
+}
+
+static int io_body(void* data){
+	tina_scheduler_run_subscription(SCHED, SUB_IO, TINA_RUN_LOOP);
+	return 0;
+}
+
+static void check_thread(tina_job* job){
+	switch(tina_job_get_description(job)->queue_idx){
+		case QUEUE_GFX: assert(thrd_equal(thrd_current(), GFX_THREAD)); break;
+		case QUEUE_IO: assert(thrd_equal(thrd_current(), IO_THREAD)); break;
+	}
+}
+
+static void wait_group(tina_group* group){
+	while(tina_group_increment(SCHED, group, 0, 0), group->_count) thrd_yield();
+}
+
+static void test_wakeups(void){
+	thrd_create(&GFX_THREAD, gfx_body, NULL);
+	thrd_create(&IO_THREAD, io_body, NULL);
+	
+	// Enqueues should wake the worker that is subscribed to the queue, even when other workers are idle too.
+	tina_group group = {0};
+	for(unsigned round = 0; round < 100; round++){
+		// Give both workers a chance to go to sleep.
+		if(round % 10 == 0) thrd_sleep(&(struct timespec){.tv_nsec = 1*MS}, NULL);
+		
+		tina_scheduler_enqueue(SCHED, check_thread, NULL, 0, QUEUE_IO, &group);
+		wait_group(&group);
+		tina_scheduler_enqueue(SCHED, check_thread, NULL, 0, QUEUE_GFX, &group);
+		wait_group(&group);
+		tina_scheduler_enqueue_n(SCHED, check_thread, NULL, 4, QUEUE_WORK, &group);
+		wait_group(&group);
+	}
+	
+	tina_scheduler_interrupt_subscription(SCHED, SUB_GFX);
+	tina_scheduler_interrupt_subscription(SCHED, SUB_IO);
+	thrd_join(GFX_THREAD, NULL);
+	thrd_join(IO_THREAD, NULL);
+	puts("test_wakeups() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(256, _QUEUE_COUNT, 16, 64*1024);
+	
+	const unsigned gfx_queues[] = {QUEUE_GFX, QUEUE_WORK};
+	SUB_GFX = tina_subscription_new(SCHED, gfx_queues, 2);
+	const unsigned io_queues[] = {QUEUE_IO, QUEUE_WORK};
+	SUB_IO = tina_subscription_new(SCHED, io_queues, 2);
+	
+	test_ordering();
+	test_wakeups();
+	
+	tina_subscription_free(SCHED, SUB_GFX);
+	tina_subscription_free(SCHED, SUB_IO);
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
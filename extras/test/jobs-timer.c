@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+enum {
+	QUEUE_MAIN,
+	QUEUE_WORK,
+	_QUEUE_COUNT,
+};
+
+#define MS 1000000ull
+
+tina_scheduler* SCHED;
+
+static void sleeper(tina_job* job){
+	uint64_t duration = tina_job_get_description(job)->user_idx*MS;
+	uint64_t start = tina_scheduler_now(SCHED);
+	tina_job_sleep(job, duration);
+	assert(tina_scheduler_now(SCHED) >= start + duration);
+}
+
+static void test_sleep(tina_job* job){
+	tina_group group = {0};
+
+	// Long enough to cascade through the second level of the wheel too.
+	const unsigned durations[] = {0, 1, 5, 20, 70, 150};
+	for(unsigned i = 0; i < sizeof(durations)/sizeof(*durations); i++){
+		tina_scheduler_enqueue(SCHED, sleeper, NULL, durations[i], QUEUE_WORK, &group);
+	}
+
+	uint64_t start = tina_scheduler_now(SCHED);
+	tina_job_wait(job, &group, 0);
+	assert(tina_scheduler_now(SCHED) - start >= 150*MS);
+
+	puts("test_sleep() success");
+}
+
+typedef struct {
+	unsigned order[16];
+	unsigned count;
+} order_ctx;
+
+static void record_order(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	order_ctx* ctx = desc->user_data;
+	ctx->order[ctx->count++] = (unsigned)desc->user_idx;
+}
+
+static void test_enqueue_at(tina_job* job){
+	order_ctx ctx = {0};
+	tina_group group = {0};
+
+	// Enqueue in reverse order. They should still run in deadline order.
+	uint64_t now = tina_scheduler_now(SCHED);
+	for(unsigned i = 0; i < 16; i++){
+		tina_job_description desc = {.func = record_order, .user_data = &ctx, .user_idx = 15 - i, .queue_idx = QUEUE_MAIN};
+		tina_scheduler_enqueue_at(SCHED, &desc, &group, now + (15 - i)*3*MS);
+	}
+
+	tina_job_wait(job, &group, 0);
+	assert(ctx.count == 16);
+	for(unsigned i = 0; i < 16; i++) assert(ctx.order[i] == i);
+
+	puts("test_enqueue_at() success");
+}
+
+static void run_tests(tina_job* job){
+	test_sleep(job);
+	test_enqueue_at(job);
+	tina_scheduler_interrupt(SCHED, QUEUE_MAIN);
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(1024, _QUEUE_COUNT, 64, 64*1024);
+	common_start_worker_threads(2, SCHED, QUEUE_WORK);
+
+	tina_scheduler_enqueue(SCHED, run_tests, NULL, 0, QUEUE_MAIN, NULL);
+	tina_scheduler_run(SCHED, QUEUE_MAIN, TINA_RUN_LOOP);
+
+	tina_scheduler_interrupt(SCHED, QUEUE_WORK);
+	common_destroy_worker_threads();
+
+	return EXIT_SUCCESS;
+}
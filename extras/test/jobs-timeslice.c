@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_jobs.h"
+#include "common/common.h"
+
+#define US 1000ull
+#define MS 1000000ull
+
+static tina_scheduler* SCHED;
+static volatile bool TICKING;
+
+// Stand in for a watchdog thread that advances the time slice clock.
+static int ticker_body(void* data){
+	while(TICKING){
+		tina_scheduler_update_timeslices(SCHED);
+		thrd_sleep(&(struct timespec){.tv_nsec = 100*US}, NULL);
+	}
+	return 0;
+}
+
+typedef struct {
+	unsigned yields, short_done;
+	bool short_done_first;
+} long_ctx;
+
+static void long_job(tina_job* job){
+	long_ctx* ctx = tina_job_get_description(job)->user_data;
+	uint64_t start = tina_scheduler_now(SCHED);
+	while(tina_scheduler_now(SCHED) < start + 20*MS){
+		if(tina_job_check_yield(job)) ctx->yields++;
+	}
+	ctx->short_done_first = (ctx->short_done == 5);
+}
+
+static void short_job(tina_job* job){
+	long_ctx* ctx = tina_job_get_description(job)->user_data;
+	ctx->short_done++;
+}
+
+static void test_timeslice(void){
+	tina_scheduler_queue_timeslice(SCHED, 0, 1*MS);
+	
+	// The short jobs are queued behind the long one, but it should yield to them.
+	long_ctx ctx = {0};
+	tina_scheduler_enqueue(SCHED, long_job, &ctx, 0, 0, NULL);
+	for(unsigned i = 0; i < 5; i++) tina_scheduler_enqueue(SCHED, short_job, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	
+	printf("Long job yielded %u times.\n", ctx.yields);
+	assert(ctx.short_done_first);
+	assert(ctx.yields >= 2 && ctx.yields <= 20);
+	puts("test_timeslice() success");
+}
+
+static void test_disabled(void){
+	tina_scheduler_queue_timeslice(SCHED, 0, 0);
+	
+	long_ctx ctx = {0};
+	tina_scheduler_enqueue(SCHED, long_job, &ctx, 0, 0, NULL);
+	for(unsigned i = 0; i < 5; i++) tina_scheduler_enqueue(SCHED, short_job, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	
+	assert(ctx.yields == 0 && !ctx.short_done_first);
+	puts("test_disabled() success");
+}
+
+typedef struct {
+	unsigned yields, order[4], count;
+} pending_ctx;
+
+static void record_order(tina_job* job){
+	const tina_job_description* desc = tina_job_get_description(job);
+	pending_ctx* ctx = desc->user_data;
+	ctx->order[ctx->count++] = (unsigned)desc->user_idx;
+}
+
+static void polite_job(tina_job* job){
+	pending_ctx* ctx = tina_job_get_description(job)->user_data;
+	for(unsigned i = 0; i < 10; i++){
+		if(tina_job_yield_if_pending(job)) ctx->yields++;
+	}
+	record_order(job);
+}
+
+static void test_yield_if_pending(void){
+	// Nothing else is waiting, so it shouldn't yield.
+	pending_ctx ctx = {0};
+	tina_scheduler_enqueue(SCHED, polite_job, &ctx, 0, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.yields == 0 && ctx.count == 1);
+	
+	// Yield once to let the queued job run, then keep going.
+	ctx = (pending_ctx){0};
+	tina_scheduler_enqueue(SCHED, polite_job, &ctx, 0, 0, NULL);
+	tina_scheduler_enqueue(SCHED, record_order, &ctx, 1, 0, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.yields == 1 && ctx.count == 2 && ctx.order[0] == 1);
+	
+	// Jobs in a low priority queue should yield to the high priority queue, but not the other way around.
+	ctx = (pending_ctx){0};
+	tina_scheduler_enqueue(SCHED, polite_job, &ctx, 0, 1, NULL);
+	tina_scheduler_enqueue(SCHED, record_order, &ctx, 1, 0, NULL);
+	tina_scheduler_run(SCHED, 1, TINA_RUN_SINGLE);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.yields == 1 && ctx.count == 2 && ctx.order[0] == 1);
+	
+	ctx = (pending_ctx){0};
+	tina_scheduler_enqueue(SCHED, polite_job, &ctx, 0, 0, NULL);
+	tina_scheduler_enqueue(SCHED, record_order, &ctx, 1, 1, NULL);
+	tina_scheduler_run(SCHED, 0, TINA_RUN_FLUSH);
+	assert(ctx.yields == 0 && ctx.count == 2 && ctx.order[0] == 0);
+	
+	puts("test_yield_if_pending() success");
+}
+
+int main(int argc, const char *argv[]){
+	SCHED = tina_scheduler_new(256, 2, 16, 64*1024);
+	tina_scheduler_queue_priority(SCHED, 0, 1);
+	
+	TICKING = true;
+	thrd_t ticker;
+	thrd_create(&ticker, ticker_body, NULL);
+	
+	test_timeslice();
+	test_disabled();
+	test_yield_if_pending();
+	
+	TICKING = false;
+	thrd_join(ticker, NULL);
+	tina_scheduler_free(SCHED);
+	return EXIT_SUCCESS;
+}
@@ -100,10 +100,42 @@ static void test_wait_multiple(tina_job* job){
 	puts("test_wait_multiple() success");
 }
 
+static void enqueue_after_increment(tina_job* job){
+	unsigned* counter = tina_job_get_description(job)->user_data;
+	(*counter)++;
+}
+
+static void enqueue_after_done(tina_job* job){
+	unsigned* counter = tina_job_get_description(job)->user_data;
+	// All of the jobs in the group must have finished before this one starts.
+	assert(*counter == 16);
+	*counter = 0;
+}
+
+static void test_enqueue_after(tina_job* job){
+	unsigned counter = 0;
+	tina_group group = {0}, done = {0};
+	
+	tina_job_description desc = {.func = enqueue_after_done, .user_data = &counter, .queue_idx = QUEUE_MAIN};
+	tina_group_increment(SCHED, &group, 1, 0);
+	tina_scheduler_enqueue_after(SCHED, &desc, &done, &group, 0);
+	
+	for(unsigned i = 0; i < 16; i++){
+		tina_scheduler_enqueue(SCHED, enqueue_after_increment, &counter, i, QUEUE_WORK, &group);
+	}
+	tina_group_decrement(SCHED, &group, 1);
+	
+	tina_job_wait(job, &done, 0);
+	assert(counter == 0);
+	
+	puts("test_enqueue_after() success");
+}
+
 static void run_tests(tina_job* job){
 	test_wait_countdown_sync(job);
 	test_wait_countdown_async(job);
 	test_wait_multiple(job);
+	test_enqueue_after(job);
 	tina_scheduler_interrupt(SCHED, QUEUE_MAIN);
 }
 
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+#include "tina_runloop.h"
+
+#define SLEEPER_COUNT 1000
+
+typedef struct {
+	tina_runloop* loop;
+	uint64_t ticks;
+	unsigned wakeups;
+} sleeper_context;
+
+static void* sleeper_body(tina* coro, void* value){
+	sleeper_context* ctx = coro->user_data;
+	for(int i = 0; i < 3; i++){
+		uint64_t start = tina_runloop_time(ctx->loop);
+		tina_sleep(coro, ctx->ticks);
+		// Every sleeper should wake on exactly the tick it asked for.
+		assert(tina_runloop_time(ctx->loop) == start + (ctx->ticks ? ctx->ticks : 1));
+		ctx->wakeups++;
+	}
+	return NULL;
+}
+
+static void test_sleep(void){
+	tina_runloop* loop = tina_runloop_new(SLEEPER_COUNT);
+	static sleeper_context contexts[SLEEPER_COUNT];
+	tina* coros[SLEEPER_COUNT];
+
+	// Spread the sleep times over every level of the wheel.
+	for(unsigned i = 0; i < SLEEPER_COUNT; i++){
+		contexts[i] = (sleeper_context){.loop = loop, .ticks = ((uint64_t)i*i*i) % 300000};
+		coros[i] = tina_init(NULL, 64*1024, sleeper_body, &contexts[i]);
+		bool added = tina_runloop_add(loop, coros[i]);
+		assert(added);
+	}
+	bool full = !tina_runloop_add(loop, coros[0]);
+	assert(full);
+
+	// Most ticks should only touch a handful of coroutines.
+	unsigned resumed = 0, ticks = 0;
+	while(tina_runloop_count(loop)){
+		resumed += tina_runloop_tick(loop);
+		ticks++;
+	}
+	assert(resumed == 4*SLEEPER_COUNT);
+	for(unsigned i = 0; i < SLEEPER_COUNT; i++) assert(contexts[i].wakeups == 3);
+
+	for(unsigned i = 0; i < SLEEPER_COUNT; i++) free(coros[i]);
+	tina_runloop_free(loop);
+	printf("test_sleep() success: %u resumes over %u ticks\n", resumed, ticks);
+}
+
+static void test_long_sleep(void){
+	tina_runloop* loop = tina_runloop_new(1);
+	// Longer than the whole wheel, so it has to cascade through the top level more than once.
+	sleeper_context ctx = {.loop = loop, .ticks = 20000000};
+	tina* coro = tina_init(NULL, 64*1024, sleeper_body, &ctx);
+	tina_runloop_add(loop, coro);
+
+	while(tina_runloop_count(loop)) tina_runloop_tick(loop);
+	assert(ctx.wakeups == 3);
+
+	free(coro);
+	tina_runloop_free(loop);
+	puts("test_long_sleep() success");
+}
+
+static bool flag_is_set(tina* coro, void* ctx){return *(bool*)ctx;}
+
+static void* waiter_body(tina* coro, void* value){
+	tina_wait_until(coro, flag_is_set, coro->user_data);
+	*(bool*)coro->user_data = false;
+	return NULL;
+}
+
+static void test_wait_until(void){
+	tina_runloop* loop = tina_runloop_new(4);
+	bool flag = false;
+	tina* coro = tina_init(NULL, 64*1024, waiter_body, &flag);
+	tina_runloop_add(loop, coro);
+
+	// Waiting coroutines aren't resumed until the predicate is true.
+	assert(tina_runloop_tick(loop) == 1);
+	for(int i = 0; i < 10; i++) assert(tina_runloop_tick(loop) == 0);
+
+	flag = true;
+	assert(tina_runloop_tick(loop) == 1);
+	assert(coro->completed && !flag);
+	assert(tina_runloop_count(loop) == 0);
+
+	free(coro);
+	tina_runloop_free(loop);
+	puts("test_wait_until() success");
+}
+
+int main(void){
+	test_sleep();
+	test_long_sleep();
+	test_wait_until();
+	return 0;
+}
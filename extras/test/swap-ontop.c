@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "tina.h"
+
+static tina* CORO_MAIN;
+static tina* CORO_A;
+static unsigned ONTOP_COUNT;
+
+static bool on_stack(tina* coro, void* ptr){
+	return (uint8_t*)coro->buffer <= (uint8_t*)ptr && (uint8_t*)ptr < (uint8_t*)coro->buffer + coro->size;
+}
+
+// Runs on A's stack after main has switched out.
+static void* ontop_enter_a(tina* from, void* value){
+	int local;
+	assert(from == CORO_MAIN);
+	assert(on_stack(CORO_A, &local));
+	ONTOP_COUNT++;
+	return (void*)((uintptr_t)value + 1);
+}
+
+// Runs on the main stack after A has switched out.
+static void* ontop_leave_a(tina* from, void* value){
+	int local;
+	assert(from == CORO_A);
+	assert(!on_stack(CORO_A, &local));
+	ONTOP_COUNT++;
+	return (void*)((uintptr_t)value*2);
+}
+
+static void* body_a(tina* coro, void* value){
+	// The first value was transformed by ontop_enter_a().
+	assert((uintptr_t)value == 2);
+	
+	value = tina_swap_ontop(coro, CORO_MAIN, ontop_leave_a, (void*)(uintptr_t)21);
+	assert((uintptr_t)value == 5);
+	
+	tina_swap(coro, CORO_MAIN, NULL);
+	abort();
+}
+
+int main(void){
+	tina main_coro = TINA_EMPTY;
+	CORO_MAIN = &main_coro;
+	CORO_A = tina_init(NULL, 64*1024, body_a, NULL);
+	
+	void* value = tina_swap_ontop(CORO_MAIN, CORO_A, ontop_enter_a, (void*)(uintptr_t)1);
+	assert((uintptr_t)value == 42);
+	
+	// A swaps back with plain tina_swap(), which must not run an on top function.
+	tina_swap_ontop(CORO_MAIN, CORO_A, ontop_enter_a, (void*)(uintptr_t)4);
+	assert(ONTOP_COUNT == 3);
+	
+	free(CORO_A->buffer);
+	puts("test_swap_ontop() success");
+	return EXIT_SUCCESS;
+}
@@ -37,6 +37,8 @@ struct tina {
 	// Private:
 	tina* _caller;
 	void* _stack_pointer;
+	// Function to run on top of this coroutine the next time it's resumed. (See tina_swap_ontop())
+	const struct _tina_ontop* _ontop;
 	// Stack canary values at the start and end of the buffer.
 	const uint32_t* _canary_end;
 	uint32_t _canary;
@@ -73,6 +75,22 @@ extern const tina TINA_EMPTY;
 // Swap between two symmetric coroutines, passing a value between them.
 void* tina_swap(tina* from, tina* to, void* value);
 
+// Function prototype for tina_swap_ontop().
+typedef void* tina_ontop_func(tina* from, void* value);
+
+// Swap between two symmetric coroutines like tina_swap(), but call 'func(from, value)' on the stack of 'to' before it resumes.
+// The value returned by 'func' is what 'to' receives. By the time 'func' runs, 'from' has completely left it's stack.
+// This makes it safe for 'func' to hand 'from' off to another thread (ex: publish it to a wait list) without holding a lock across the swap.
+void* tina_swap_ontop(tina* from, tina* to, tina_ontop_func* func, void* value);
+
+// Function prototype for tina_call_on_stack().
+typedef void* tina_call_func(void* arg);
+
+// Call a function on a different stack and return it's result. This is not a coroutine, it cannot yield.
+// It's a cheap way to borrow a big stack for a deeply recursive call without the overhead of tina_init().
+// Unlike tina_init(), the whole buffer is used as the stack and no canary values are written to it.
+void* tina_call_on_stack(void* buffer, size_t size, tina_call_func* func, void* arg);
+
 #ifdef TINA_IMPLEMENTATION
 
 #define TINA_ABI_aarch32 (__ARM_EABI__ && __GNUC__)
@@ -113,7 +131,7 @@ void* tina_swap(tina* from, tina* to, void* value);
 const tina TINA_EMPTY = {
 	.body = NULL, .user_data = NULL, .name = "TINA_EMPTY",
 	.buffer = NULL, .size = 0, .completed = false,
-	._caller = NULL, ._stack_pointer = NULL,
+	._caller = NULL, ._stack_pointer = NULL, ._ontop = NULL,
 	._canary_end = &TINA_EMPTY._canary, ._canary = 0x54494E41ul,
 };
 
@@ -122,10 +140,12 @@ const tina TINA_EMPTY = {
 #if __WIN64__ || _WIN64
 	extern const uint64_t _tina_swap[];
 	extern const uint64_t _tina_init_stack[];
+	extern const uint64_t _tina_call_on_stack[];
 #else
 	// Avoid the MSVC hack unless necessary!
 	extern void* _tina_swap(void** sp_from, void** sp_to, void* value);
 	extern tina* _tina_init_stack(tina* coro, void** sp_from, void* sp_to);
+	extern void* _tina_call_on_stack(void* stack_end, void* stack_top, tina_call_func* func, void* arg);
 #endif
 
 tina* tina_init(void* buffer, size_t size, tina_func* body, void* user_data){
@@ -145,7 +165,7 @@ tina* tina_init(void* buffer, size_t size, tina_func* body, void* user_data){
 	tina coro_value = {
 		.body = body, .user_data = user_data, .name = "<no name>",
 		.buffer = buffer, .size = size, .completed = false,
-		._caller = NULL, ._stack_pointer = NULL,
+		._caller = NULL, ._stack_pointer = NULL, ._ontop = NULL,
 		._canary_end = (uint32_t*)stack_end,
 		._canary = TINA_EMPTY._canary,
 	};
@@ -179,11 +199,33 @@ void _tina_start(tina* coro){
 #endif
 }
 
+struct _tina_ontop {
+	tina_ontop_func* func;
+	tina* from;
+};
+
 void* tina_swap(tina* from, tina* to, void* value){
 	_TINA_ASSERT(from->_canary == TINA_EMPTY._canary, "Tina Error: Bad canary value. Coroutine has likely had a stack overflow.");
 	_TINA_ASSERT(*from->_canary_end == TINA_EMPTY._canary, "Tina Error: Bad canary value. Coroutine has likely had a stack underflow.");
 	typedef void* swap(void** sp_from, void** sp_to, void* value);
-	return ((swap*)(void*)_tina_swap)(&from->_stack_pointer, &to->_stack_pointer, value);
+	value = ((swap*)(void*)_tina_swap)(&from->_stack_pointer, &to->_stack_pointer, value);
+	
+	// Now running as 'from' again. Every suspended coroutine resumes here, so this is where on top functions are run.
+	const struct _tina_ontop* ontop = from->_ontop;
+	if(ontop){
+		from->_ontop = NULL;
+		// Copy it out first. It lives on the other stack, and 'func' may allow it to be resumed.
+		struct _tina_ontop request = (*ontop);
+		value = request.func(request.from, value);
+	}
+	return value;
+}
+
+void* tina_swap_ontop(tina* from, tina* to, tina_ontop_func* func, void* value){
+	_TINA_ASSERT(!to->_ontop, "Tina Error: Coroutine already has an on top function pending.");
+	struct _tina_ontop ontop = {.func = func, .from = from};
+	to->_ontop = &ontop;
+	return tina_swap(from, to, value);
 }
 
 void* tina_resume(tina* coro, void* value){
@@ -200,6 +242,12 @@ void* tina_yield(tina* coro, void* value){
 	return tina_swap(coro, caller, value);
 }
 
+void* tina_call_on_stack(void* buffer, size_t size, tina_call_func* func, void* arg){
+	// The asm aligns the top of the stack, and the Win64 version needs the bottom to update the TIB.
+	typedef void* call_func(void* stack_end, void* stack_top, tina_call_func* func, void* arg);
+	return ((call_func*)(void*)_tina_call_on_stack)(buffer, (uint8_t*)buffer + size, func, arg);
+}
+
 #if __APPLE__ || __WIN32__
 	#define _TINA_SYMBOL(sym) "_"#sym
 #else
@@ -246,6 +294,21 @@ void* tina_yield(tina* coro, void* value){
 	// And perform a normal return instruction.
 	// This will return from tina_yield() in the new coroutine.
 	asm("  bx lr");
+	
+	// _tina_call_on_stack() calls a function on a new stack, then switches back.
+	asm("_tina_call_on_stack:");
+	// Save r4 to hold the old stack pointer. (Pushing a pair keeps the stack 8 byte aligned)
+	asm("  push {r4, lr}");
+	asm("  mov r4, sp");
+	// Align and switch to the new stack.
+	asm("  and r1, r1, #-16");
+	asm("  mov sp, r1");
+	// Call 'func(arg)'. r0 holds the return value when it's done.
+	asm("  mov r0, r3");
+	asm("  blx r2");
+	// Restore the old stack and return.
+	asm("  mov sp, r4");
+	asm("  pop {r4, pc}");
 #elif TINA_ABI_riscv64gc
 	// 64bit riscv w/ 64 bit floats
 	// push s0-s11, fs0-fs11
@@ -340,6 +403,21 @@ void* tina_yield(tina* coro, void* value){
 	asm("  addi sp, sp, 0xD0");
 	asm("  mv a0, a2");
 	asm("  ret");
+	
+	asm("_tina_call_on_stack:");
+	asm("  addi sp, sp, -0x10");
+	asm("  sd ra, 0x08(sp)");
+	asm("  sd s0, 0x00(sp)");
+	asm("  mv s0, sp");
+	asm("  andi a1, a1, ~0xF");
+	asm("  mv sp, a1");
+	asm("  mv a0, a3");
+	asm("  jalr a2");
+	asm("  mv sp, s0");
+	asm("  ld ra, 0x08(sp)");
+	asm("  ld s0, 0x00(sp)");
+	asm("  addi sp, sp, 0x10");
+	asm("  ret");
 #elif TINA_ABI_aarch64
 	asm(_TINA_SYMBOL(_tina_init_stack:));
 	asm("  sub sp, sp, 0xA0");
@@ -389,6 +467,17 @@ void* tina_yield(tina* coro, void* value){
 	asm("  add sp, sp, 0xA0");
 	asm("  mov x0, x2");
 	asm("  ret");
+	
+	asm(_TINA_SYMBOL(_tina_call_on_stack:));
+	asm("  stp x29, x30, [sp, -0x10]!");
+	asm("  mov x29, sp");
+	asm("  and x1, x1, #-16");
+	asm("  mov sp, x1");
+	asm("  mov x0, x3");
+	asm("  blr x2");
+	asm("  mov sp, x29");
+	asm("  ldp x29, x30, [sp], 0x10");
+	asm("  ret");
 #elif TINA_ABI_i386
 	#if __GNUC__
 		asm(".intel_syntax noprefix");
@@ -437,6 +526,30 @@ void* tina_yield(tina* coro, void* value){
 		TINA_I386ASM(pop ebx);
 		TINA_I386ASM(pop ebp);
 		TINA_I386ASM(ret);
+	#if __GNUC__
+	#elif _MSC_VER
+		}
+	#endif
+	
+	#if __GNUC__
+		asm(_TINA_SYMBOL(_tina_call_on_stack:));
+	#elif _MSC_VER
+		__declspec(naked) void* _tina_call_on_stack(void* stack_end, void* stack_top, tina_call_func* func, void* arg){
+	#endif
+		TINA_I386ASM(push ebp);
+		TINA_I386ASM(mov ebp, esp);
+		TINA_I386ASM(mov eax, [ebp + 0x0C]); // stack_top
+		TINA_I386ASM(mov ecx, [ebp + 0x10]); // func
+		TINA_I386ASM(mov edx, [ebp + 0x14]); // arg
+		TINA_I386ASM(and eax, -16);
+		TINA_I386ASM(mov esp, eax);
+		// Keep the stack 16 byte aligned at the call.
+		TINA_I386ASM(sub esp, 12);
+		TINA_I386ASM(push edx);
+		TINA_I386ASM(call ecx);
+		TINA_I386ASM(mov esp, ebp);
+		TINA_I386ASM(pop ebp);
+		TINA_I386ASM(ret);
 	#if __GNUC__
 		asm(".att_syntax");
 	#elif _MSC_VER
@@ -477,6 +590,17 @@ void* tina_yield(tina* coro, void* value){
 	asm("  mov rax, rdx"); // rax = ret, rdx = arg2
 	asm("  ret");
 	
+	asm(_TINA_SYMBOL(_tina_call_on_stack:));
+	asm("  push rbp");
+	asm("  mov rbp, rsp");
+	asm("  and rsi, -16"); // rsi = arg1
+	asm("  mov rsp, rsi");
+	asm("  mov rdi, rcx"); // rcx = arg3
+	asm("  call rdx"); // rdx = arg2
+	asm("  mov rsp, rbp");
+	asm("  pop rbp");
+	asm("  ret");
+	
 	asm(".att_syntax");
 #elif TINA_ABI_WIN64
 	// MSVC doesn't allow inline assembly, assemble to binary blob then.
@@ -524,6 +648,18 @@ void* tina_yield(tina* coro, void* value){
 		0x8f65000000102504, 0x5f41000000082504,
 		0x5e5f5c415d415e41, 0x9090c3c0894c5d5b,
 	};
+	
+	// Assembled and dumped from win64-call.S
+	TINA_SECTION_ATTRIBUTE
+	const uint64_t _tina_call_on_stack[] = {
+		0x2534ff65e5894855, 0x2534ff6500000008,
+		0x2534ff6500000010, 0x0c89486500001478,
+		0x8948650000147825, 0x834800000010250c,
+		0x082514894865f0e2, 0x8348d48948000000,
+		0xd0ff41c9894c20ec, 0x25048f65e8658d48,
+		0x25048f6500001478, 0x25048f6500000010,
+		0x9090c35d00000008,
+	};
 
 // RV32 variants provided by https://github.com/28530367, thanks!
 #elif TINA_ABI_riscv32d
@@ -633,6 +769,21 @@ void* tina_yield(tina* coro, void* value){
 	asm("  addi sp, sp, 0x9C");          // Deallocate stack space
 	asm("  mv a0, a2");                  // Set return value
 	asm("  ret");                        // Return to caller
+	
+	asm("_tina_call_on_stack:");
+	asm("  addi sp, sp, -0x10");         // Allocate stack space
+	asm("  sw ra,   0x0C(sp)");          // Save return address
+	asm("  sw s0,   0x08(sp)");          // Save s0 to hold the old stack pointer
+	asm("  mv s0, sp");
+	asm("  andi a1, a1, ~0xF");          // Align the new stack
+	asm("  mv sp, a1");                  // Switch stacks
+	asm("  mv a0, a3");                  // Pass 'arg'
+	asm("  jalr a2");                    // Call 'func'
+	asm("  mv sp, s0");                  // Restore the old stack
+	asm("  lw ra,   0x0C(sp)");          // Restore return address
+	asm("  lw s0,   0x08(sp)");          // Restore s0
+	asm("  addi sp, sp, 0x10");          // Deallocate stack space
+	asm("  ret");                        // Return
 
 #elif TINA_ABI_riscv32f
 	// 32-bit CPU + Single-Precision FPU (RV32F)
@@ -741,6 +892,21 @@ void* tina_yield(tina* coro, void* value){
 	asm("  addi sp, sp, 0x68");       // Deallocate stack space
 	asm("  mv a0, a2");               // Set return value
 	asm("  ret");                     // Return to caller
+	
+	asm("_tina_call_on_stack:");
+	asm("  addi sp, sp, -0x10");         // Allocate stack space
+	asm("  sw ra,   0x0C(sp)");          // Save return address
+	asm("  sw s0,   0x08(sp)");          // Save s0 to hold the old stack pointer
+	asm("  mv s0, sp");
+	asm("  andi a1, a1, ~0xF");          // Align the new stack
+	asm("  mv sp, a1");                  // Switch stacks
+	asm("  mv a0, a3");                  // Pass 'arg'
+	asm("  jalr a2");                    // Call 'func'
+	asm("  mv sp, s0");                  // Restore the old stack
+	asm("  lw ra,   0x0C(sp)");          // Restore return address
+	asm("  lw s0,   0x08(sp)");          // Restore s0
+	asm("  addi sp, sp, 0x10");          // Deallocate stack space
+	asm("  ret");                        // Return
 
 #elif TINA_ABI_riscv32i
 	asm("_tina_init_stack:");
@@ -797,6 +963,21 @@ void* tina_yield(tina* coro, void* value){
 	asm("  addi sp, sp, 0x38");          // Deallocate stack space
 	asm("  mv a0, a2");                  // Set return value to a2
 	asm("  ret");                        // Return
+	
+	asm("_tina_call_on_stack:");
+	asm("  addi sp, sp, -0x10");         // Allocate stack space
+	asm("  sw ra,   0x0C(sp)");          // Save return address
+	asm("  sw s0,   0x08(sp)");          // Save s0 to hold the old stack pointer
+	asm("  mv s0, sp");
+	asm("  andi a1, a1, ~0xF");          // Align the new stack
+	asm("  mv sp, a1");                  // Switch stacks
+	asm("  mv a0, a3");                  // Pass 'arg'
+	asm("  jalr a2");                    // Call 'func'
+	asm("  mv sp, s0");                  // Restore the old stack
+	asm("  lw ra,   0x0C(sp)");          // Restore return address
+	asm("  lw s0,   0x08(sp)");          // Restore s0
+	asm("  addi sp, sp, 0x10");          // Deallocate stack space
+	asm("  ret");                        // Return
 #else
 	#error Unhandled target CPU/ABI/Compiler combination!
 #endif
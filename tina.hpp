@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#ifndef TINA_HPP
+#define TINA_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "tina.h"
+
+namespace tina_cpp_detail {
+	// Round up to the alignment malloc() guarantees so the stack after the closure stays aligned.
+	constexpr size_t align(size_t n){return (n + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);}
+}
+
+namespace tina_cpp {
+
+// Move only RAII wrapper for an assymmetric coroutine with a C++ callable as it's body.
+// The callable is stored inline at the start of the coroutine's buffer so there is only a single allocation.
+// The body is called as 'body(tina* coro, void* value)', and may return either void or void*.
+// NOTE: Destroying an unfinished coroutine discards it's stack without unwinding it, just like the C API.
+class coroutine {
+public:
+	coroutine() noexcept = default;
+
+	template<typename F>
+	coroutine(size_t size, F&& body){
+		using Fn = std::decay_t<F>;
+		static_assert(std::is_invocable_v<Fn&, ::tina*, void*>, "Tina Error: Coroutine body must be callable as body(tina*, void*).");
+		// The closure goes at the start of the buffer, so it only gets malloc()'s alignment.
+		static_assert(alignof(Fn) <= alignof(std::max_align_t), "Tina Error: Coroutine body is over aligned.");
+
+		const size_t offset = tina_cpp_detail::align(sizeof(Fn));
+		std::unique_ptr<void, void (*)(void*)> buffer(std::malloc(offset + size), std::free);
+		if(!buffer) throw std::bad_alloc();
+
+		// Don't take ownership of the buffer until the closure is constructed, in case it throws.
+		Fn* closure = ::new(buffer.get()) Fn(std::forward<F>(body));
+		_destroy = [](void* ptr){static_cast<Fn*>(ptr)->~Fn();};
+		_coro = tina_init((char*)buffer.get() + offset, size, _body<Fn>, closure);
+		_buffer = buffer.release();
+	}
+
+	coroutine(coroutine&& other) noexcept {swap(other);}
+	coroutine& operator=(coroutine&& other) noexcept {coroutine tmp(std::move(other)); swap(tmp); return *this;}
+	coroutine(const coroutine&) = delete;
+	coroutine& operator=(const coroutine&) = delete;
+
+	~coroutine(){
+		if(_buffer){
+			_destroy(_buffer);
+			std::free(_buffer);
+		}
+	}
+
+	void swap(coroutine& other) noexcept {
+		std::swap(_coro, other._coro);
+		std::swap(_buffer, other._buffer);
+		std::swap(_destroy, other._destroy);
+	}
+
+	// Resume the coroutine, see tina_resume().
+	void* resume(void* value = nullptr){return tina_resume(_coro, value);}
+	// Has the coroutine's body function exited?
+	bool completed() const {return _coro->completed;}
+	// Get the underlying C coroutine.
+	::tina* get() const noexcept {return _coro;}
+	explicit operator bool() const noexcept {return _coro != nullptr;}
+
+private:
+	::tina* _coro = nullptr;
+	void* _buffer = nullptr;
+	void (*_destroy)(void* closure) = nullptr;
+
+	template<typename Fn>
+	static void* _body(::tina* coro, void* value){
+		Fn& body = *static_cast<Fn*>(coro->user_data);
+		if constexpr(std::is_void_v<std::invoke_result_t<Fn&, ::tina*, void*>>){
+			body(coro, value);
+			return nullptr;
+		} else {
+			return body(coro, value);
+		}
+	}
+};
+
+} // namespace tina_cpp
+
+#endif // TINA_HPP
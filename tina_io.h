@@ -0,0 +1,758 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#ifndef TINA_IO_H
+#define TINA_IO_H
+
+// Linux only I/O reactor for plain tina coroutines.
+// Operations suspend the calling coroutine with tina_yield(coro, NULL), and tina_io_poll() resumes it with the result.
+// Submissions are batched through io_uring when the kernel supports it, otherwise readiness is polled with epoll.
+// Results follow the io_uring convention: The byte count (or new fd) on success, or a negative errno value on failure.
+// NOTE: The epoll backend switches file descriptors to non-blocking mode.
+// NOTE: tina_yield() returns to whoever resumed the coroutine, so plain tina_resume() or tina_io_poll() both work to run it.
+
+#if defined(__linux__)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Opaque type for a reactor.
+typedef struct tina_io tina_io;
+
+typedef enum {
+	// Use io_uring if available, otherwise fall back to epoll.
+	TINA_IO_BACKEND_AUTO,
+	// Use io_uring or fail.
+	TINA_IO_BACKEND_URING,
+	// Always use epoll.
+	TINA_IO_BACKEND_EPOLL,
+} tina_io_backend;
+
+// Create a reactor. 'entries' is the size of the io_uring submission queue, and is ignored by epoll.
+// Returns NULL if the requested backend isn't available.
+tina_io* tina_io_new(unsigned entries, tina_io_backend backend);
+// Destroy a reactor. Coroutines with pending operations are never resumed.
+void tina_io_free(tina_io* io);
+// Which backend is the reactor using? (never returns TINA_IO_BACKEND_AUTO)
+tina_io_backend tina_io_get_backend(const tina_io* io);
+// Register buffers for use with tina_io_read_fixed() and tina_io_write_fixed(). Returns 0 or a negative errno value.
+// With io_uring the pages are pinned once instead of mapped on every operation. Does nothing with epoll.
+int tina_io_register_buffers(tina_io* io, const struct iovec* iovecs, unsigned count);
+
+// Number of operations that haven't resumed their coroutines yet.
+unsigned tina_io_pending(const tina_io* io);
+// Submit queued operations and resume coroutines in the order their operations completed.
+// If 'wait' is true, block until at least one operation completes. (unless nothing is pending)
+// Returns the number of coroutines resumed.
+unsigned tina_io_poll(tina_io* io, bool wait);
+
+// Suspend 'coro' until the operation completes. Must be called from within 'coro'.
+ssize_t tina_io_read(tina_io* io, tina* coro, int fd, void* buf, size_t len);
+ssize_t tina_io_write(tina_io* io, tina* coro, int fd, const void* buf, size_t len);
+// Same as tina_io_read()/tina_io_write(), but 'buf' must be within the registered buffer 'buf_index'.
+ssize_t tina_io_read_fixed(tina_io* io, tina* coro, int fd, void* buf, size_t len, unsigned buf_index);
+ssize_t tina_io_write_fixed(tina_io* io, tina* coro, int fd, const void* buf, size_t len, unsigned buf_index);
+// Returns the accepted fd or a negative errno value. 'addr' and 'addrlen' are optional like accept().
+int tina_io_accept(tina_io* io, tina* coro, int fd, struct sockaddr* addr, socklen_t* addrlen);
+
+#ifdef TINA_JOBS_H
+// Job integration. Include tina_jobs.h first to enable it.
+// A scheduler can have a single io_uring shared by all of it's jobs. Requests park the job, so it doesn't hold a worker
+// thread while it waits, and the job is pushed back onto it's queue when the request completes.
+// Requests from many jobs are batched up until the next tina_jobs_io_poll(), or are submitted immediately if a thread is blocked in it.
+// NOTE: The implementation must be in the same file as TINA_JOBS_IMPLEMENTATION.
+
+// Opaque type for a scheduler's I/O ring.
+typedef struct tina_jobs_io tina_jobs_io;
+
+// Attach an io_uring to a scheduler with a submission queue of 'entries'. Returns NULL if io_uring isn't available.
+// Without one, tina_job_read() and friends fall back to blocking syscalls.
+tina_jobs_io* tina_jobs_io_new(tina_scheduler* sched, unsigned entries);
+// Detach and free the ring. All requests must have completed.
+void tina_jobs_io_free(tina_jobs_io* io);
+// Submit batched requests and re-enqueue the jobs whose requests completed. Returns the number of jobs re-enqueued.
+// (Workers re-enqueue jobs themselves if they have to reap completions to make room in a full ring)
+// If 'wait' is true, block until at least one request completes or tina_jobs_io_interrupt() is called.
+// Only a single thread should poll at a time, but it doesn't need to be a worker.
+unsigned tina_jobs_io_poll(tina_jobs_io* io, bool wait);
+// Wake up a thread blocked in tina_jobs_io_poll().
+void tina_jobs_io_interrupt(tina_jobs_io* io);
+
+// Park the job until the request completes. Same as pread()/pwrite()/fsync(), but returns a negative errno value on failure.
+ssize_t tina_job_read(tina_job* job, int fd, void* buf, size_t len, uint64_t offset);
+ssize_t tina_job_write(tina_job* job, int fd, const void* buf, size_t len, uint64_t offset);
+int tina_job_fsync(tina_job* job, int fd);
+#endif
+
+#ifdef TINA_IO_IMPLEMENTATION
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if defined(__has_include)
+	#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+		#define _TINA_IO_URING 1
+		#include <linux/io_uring.h>
+	#endif
+#endif
+
+#ifdef _TINA_IO_URING
+// Raw io_uring submission and completion rings. Shared by the coroutine reactor and the job scheduler integration.
+typedef struct {
+	int fd;
+	unsigned sq_entries, to_submit;
+	unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+	unsigned *cq_head, *cq_tail, *cq_mask;
+	struct io_uring_sqe* sqes;
+	struct io_uring_cqe* cqes;
+	void *sq_map, *cq_map;
+	size_t sq_map_size, cq_map_size, sqes_size;
+} _tina_io_ring;
+
+// Setup a ring, and make sure the kernel is new enough to support all of the 'required' opcodes.
+static bool _tina_io_ring_init(_tina_io_ring* ring, unsigned entries, const unsigned* required, unsigned required_count){
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+	if(ring->fd < 0) return false;
+
+	uint8_t probe_buffer[sizeof(struct io_uring_probe) + 256*sizeof(struct io_uring_probe_op)] __attribute__((aligned(8)));
+	memset(probe_buffer, 0, sizeof(probe_buffer));
+	struct io_uring_probe* probe = (struct io_uring_probe*)probe_buffer;
+	bool supported = syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+	for(unsigned i = 0; supported && i < required_count; i++){
+		supported = required[i] <= probe->last_op && (probe->ops[required[i]].flags & IO_URING_OP_SUPPORTED);
+	}
+	if(!supported){
+		close(ring->fd);
+		return false;
+	}
+
+	ring->sq_entries = params.sq_entries;
+	ring->to_submit = 0;
+	ring->sq_map_size = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+	ring->cq_map_size = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+	ring->sqes_size = params.sq_entries*sizeof(struct io_uring_sqe);
+
+	bool single_map = params.features & IORING_FEAT_SINGLE_MMAP;
+	if(single_map && ring->cq_map_size > ring->sq_map_size) ring->sq_map_size = ring->cq_map_size;
+
+	ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	ring->cq_map = single_map ? ring->sq_map : mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+	ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if(ring->sq_map == MAP_FAILED || ring->cq_map == MAP_FAILED || (void*)ring->sqes == MAP_FAILED){
+		if(ring->sq_map != MAP_FAILED) munmap(ring->sq_map, ring->sq_map_size);
+		if(!single_map && ring->cq_map != MAP_FAILED) munmap(ring->cq_map, ring->cq_map_size);
+		if((void*)ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+		close(ring->fd);
+		return false;
+	}
+
+	uint8_t* sq = (uint8_t*)ring->sq_map;
+	ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+	ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+	ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+
+	uint8_t* cq = (uint8_t*)ring->cq_map;
+	ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+	ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+	ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+	return true;
+}
+
+static void _tina_io_ring_destroy(_tina_io_ring* ring){
+	munmap(ring->sqes, ring->sqes_size);
+	if(ring->cq_map != ring->sq_map) munmap(ring->cq_map, ring->cq_map_size);
+	munmap(ring->sq_map, ring->sq_map_size);
+	close(ring->fd);
+}
+
+// Submit 'to_submit' queued entries and optionally wait for completions. Returns the number submitted or a negative errno value.
+static int _tina_io_ring_enter(_tina_io_ring* ring, unsigned to_submit, unsigned min_complete){
+	unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+	int submitted = (int)syscall(__NR_io_uring_enter, ring->fd, to_submit, min_complete, flags, NULL, 0);
+	return submitted < 0 ? -errno : submitted;
+}
+
+// Submit everything queued so far and optionally wait for completions.
+static int _tina_io_ring_submit(_tina_io_ring* ring, unsigned min_complete){
+	int submitted = _tina_io_ring_enter(ring, ring->to_submit, min_complete);
+	if(submitted > 0) ring->to_submit -= submitted;
+	return submitted;
+}
+
+static inline bool _tina_io_ring_full(_tina_io_ring* ring){
+	return *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == ring->sq_entries;
+}
+
+// Get a zeroed entry at the tail of the submission queue. It's not visible to the kernel until committed.
+static inline struct io_uring_sqe* _tina_io_ring_next_sqe(_tina_io_ring* ring){
+	struct io_uring_sqe* sqe = &ring->sqes[*ring->sq_tail & *ring->sq_mask];
+	memset(sqe, 0, sizeof(*sqe));
+	return sqe;
+}
+
+static inline void _tina_io_ring_commit(_tina_io_ring* ring){
+	unsigned tail = *ring->sq_tail;
+	unsigned idx = tail & *ring->sq_mask;
+	ring->sq_array[idx] = idx;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	ring->to_submit++;
+}
+#endif
+
+enum {
+	_TINA_IO_READ,
+	_TINA_IO_WRITE,
+	_TINA_IO_READ_FIXED,
+	_TINA_IO_WRITE_FIXED,
+	_TINA_IO_ACCEPT,
+	_TINA_IO_FSYNC,
+};
+
+// Operations live on the suspended coroutine's stack, so nothing is allocated per operation.
+typedef struct _tina_io_op _tina_io_op;
+struct _tina_io_op {
+	tina* coro;
+	_tina_io_op* next;
+	int opcode, fd;
+	void* buf;
+	size_t len;
+	// Registered buffer index for fixed operations.
+	unsigned buf_index;
+	// Address length for accept. ('buf' is the address)
+	socklen_t* addrlen;
+	intptr_t result;
+};
+
+// Operations waiting on a file descriptor for the epoll backend.
+typedef struct {
+	_tina_io_op* head;
+	uint32_t events;
+} _tina_io_fd;
+
+struct tina_io {
+	tina_io_backend _backend;
+	unsigned _pending;
+	// Completed operations waiting to resume their coroutines.
+	_tina_io_op* _completed_head;
+	_tina_io_op* _completed_tail;
+
+#ifdef _TINA_IO_URING
+	_tina_io_ring _ring;
+#endif
+
+	int _epoll_fd;
+	_tina_io_fd* _fds;
+	unsigned _fd_capacity;
+};
+
+static inline intptr_t _tina_io_errno(intptr_t result){return result < 0 ? -errno : result;}
+
+static void _tina_io_complete(tina_io* io, _tina_io_op* op, intptr_t result){
+	op->result = result;
+	op->next = NULL;
+	if(io->_completed_tail){
+		io->_completed_tail->next = op;
+	} else {
+		io->_completed_head = op;
+	}
+	io->_completed_tail = op;
+}
+
+#ifdef _TINA_IO_URING
+static bool _tina_io_uring_init(tina_io* io, unsigned entries){
+	const unsigned required[] = {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED, IORING_OP_ACCEPT};
+	if(!_tina_io_ring_init(&io->_ring, entries, required, sizeof(required)/sizeof(*required))) return false;
+	io->_backend = TINA_IO_BACKEND_URING;
+	return true;
+}
+
+// Move completed entries onto the completed list.
+static void _tina_io_uring_reap(tina_io* io){
+	_tina_io_ring* ring = &io->_ring;
+	unsigned head = *ring->cq_head;
+	unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+	for(; head != tail; head++){
+		struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+		_tina_io_complete(io, (_tina_io_op*)(uintptr_t)cqe->user_data, cqe->res);
+	}
+	__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+static void _tina_io_uring_submit(tina_io* io, _tina_io_op* op){
+	// Flush the queue to the kernel until there's room. It refuses new entries while the completion queue is overflowing.
+	while(_tina_io_ring_full(&io->_ring)){
+		int submitted = _tina_io_ring_submit(&io->_ring, 0);
+		if(submitted == -EBUSY || submitted == -EAGAIN || submitted == -EINTR){
+			_tina_io_uring_reap(io);
+		} else if(submitted <= 0){
+			// Fail the operation instead of overwriting an entry the kernel hasn't seen yet.
+			_tina_io_complete(io, op, submitted < 0 ? submitted : -EBUSY);
+			return;
+		}
+	}
+
+	struct io_uring_sqe* sqe = _tina_io_ring_next_sqe(&io->_ring);
+	sqe->fd = op->fd;
+	sqe->addr = (uintptr_t)op->buf;
+	sqe->len = (uint32_t)op->len;
+	// -1 means use (and update) the file position, same as read()/write().
+	sqe->off = (uint64_t)-1;
+	sqe->user_data = (uintptr_t)op;
+
+	switch(op->opcode){
+		case _TINA_IO_READ: sqe->opcode = IORING_OP_READ; break;
+		case _TINA_IO_WRITE: sqe->opcode = IORING_OP_WRITE; break;
+		case _TINA_IO_READ_FIXED: sqe->opcode = IORING_OP_READ_FIXED; sqe->buf_index = (uint16_t)op->buf_index; break;
+		case _TINA_IO_WRITE_FIXED: sqe->opcode = IORING_OP_WRITE_FIXED; sqe->buf_index = (uint16_t)op->buf_index; break;
+		case _TINA_IO_ACCEPT: sqe->opcode = IORING_OP_ACCEPT; sqe->len = 0; sqe->off = (uintptr_t)op->addrlen; break;
+	}
+
+	_tina_io_ring_commit(&io->_ring);
+}
+
+static void _tina_io_uring_poll(tina_io* io, bool wait){
+	_tina_io_ring_submit(&io->_ring, wait ? 1 : 0);
+	_tina_io_uring_reap(io);
+}
+#endif
+
+static intptr_t _tina_io_perform(_tina_io_op* op){
+	switch(op->opcode){
+		case _TINA_IO_READ: case _TINA_IO_READ_FIXED: return _tina_io_errno(read(op->fd, op->buf, op->len));
+		case _TINA_IO_WRITE: case _TINA_IO_WRITE_FIXED: return _tina_io_errno(write(op->fd, op->buf, op->len));
+		case _TINA_IO_ACCEPT: return _tina_io_errno(accept(op->fd, (struct sockaddr*)op->buf, op->addrlen));
+		default: return -EINVAL;
+	}
+}
+
+static inline bool _tina_io_is_write(const _tina_io_op* op){
+	return op->opcode == _TINA_IO_WRITE || op->opcode == _TINA_IO_WRITE_FIXED;
+}
+
+// Sync the epoll registration for a file descriptor with the operations waiting on it.
+static int _tina_io_epoll_update(tina_io* io, int fd){
+	_tina_io_fd* entry = &io->_fds[fd];
+	uint32_t events = 0;
+	for(_tina_io_op* op = entry->head; op; op = op->next) events |= _tina_io_is_write(op) ? EPOLLOUT : EPOLLIN;
+	if(events == entry->events) return 0;
+
+	struct epoll_event event = {.events = events, .data = {.fd = fd}};
+	int ctl = entry->events == 0 ? EPOLL_CTL_ADD : (events ? EPOLL_CTL_MOD : EPOLL_CTL_DEL);
+	if(epoll_ctl(io->_epoll_fd, ctl, fd, &event) < 0) return -errno;
+	entry->events = events;
+	return 0;
+}
+
+static void _tina_io_epoll_submit(tina_io* io, _tina_io_op* op){
+	int fd = op->fd;
+	if(fd < 0){
+		_tina_io_complete(io, op, -EBADF);
+		return;
+	}
+
+	if((unsigned)fd >= io->_fd_capacity){
+		unsigned capacity = io->_fd_capacity ? io->_fd_capacity : 64;
+		while(capacity <= (unsigned)fd) capacity *= 2;
+		_tina_io_fd* fds = (_tina_io_fd*)realloc(io->_fds, capacity*sizeof(_tina_io_fd));
+		if(!fds){
+			_tina_io_complete(io, op, -ENOMEM);
+			return;
+		}
+		memset(fds + io->_fd_capacity, 0, (capacity - io->_fd_capacity)*sizeof(_tina_io_fd));
+		io->_fds = fds;
+		io->_fd_capacity = capacity;
+	}
+
+	int flags = fcntl(fd, F_GETFL);
+	if(flags >= 0 && !(flags & O_NONBLOCK)) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+	// Append so operations on the same fd are attempted in submission order.
+	_tina_io_op** cursor = &io->_fds[fd].head;
+	while(*cursor) cursor = &(*cursor)->next;
+	op->next = NULL;
+	*cursor = op;
+
+	int err = _tina_io_epoll_update(io, fd);
+	if(err){
+		// Unlink it again. Regular files can't be polled (EPERM), but are always ready so just do them now.
+		*cursor = NULL;
+		_tina_io_complete(io, op, err == -EPERM ? _tina_io_perform(op) : err);
+	}
+}
+
+static void _tina_io_epoll_poll(tina_io* io, bool wait){
+	struct epoll_event events[64];
+	int count = epoll_wait(io->_epoll_fd, events, 64, wait ? -1 : 0);
+	for(int i = 0; i < count; i++){
+		int fd = events[i].data.fd;
+		bool readable = events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP);
+		bool writable = events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP);
+
+		_tina_io_op** cursor = &io->_fds[fd].head;
+		while(*cursor){
+			_tina_io_op* op = *cursor;
+			intptr_t result = -EAGAIN;
+			if(_tina_io_is_write(op) ? writable : readable) result = _tina_io_perform(op);
+
+			if(result == -EAGAIN || result == -EWOULDBLOCK){
+				cursor = &op->next;
+			} else {
+				*cursor = op->next;
+				_tina_io_complete(io, op, result);
+			}
+		}
+
+		_tina_io_epoll_update(io, fd);
+	}
+}
+
+tina_io* tina_io_new(unsigned entries, tina_io_backend backend){
+	tina_io* io = (tina_io*)calloc(1, sizeof(tina_io));
+	if(!io) return NULL;
+	io->_epoll_fd = -1;
+
+#ifdef _TINA_IO_URING
+	if(backend != TINA_IO_BACKEND_EPOLL && _tina_io_uring_init(io, entries ? entries : 256)) return io;
+#endif
+
+	if(backend == TINA_IO_BACKEND_URING){
+		free(io);
+		return NULL;
+	}
+
+	io->_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if(io->_epoll_fd < 0){
+		free(io);
+		return NULL;
+	}
+
+	io->_backend = TINA_IO_BACKEND_EPOLL;
+	return io;
+}
+
+void tina_io_free(tina_io* io){
+#ifdef _TINA_IO_URING
+	if(io->_backend == TINA_IO_BACKEND_URING) _tina_io_ring_destroy(&io->_ring);
+#endif
+
+	if(io->_epoll_fd >= 0) close(io->_epoll_fd);
+	free(io->_fds);
+	free(io);
+}
+
+tina_io_backend tina_io_get_backend(const tina_io* io){return io->_backend;}
+unsigned tina_io_pending(const tina_io* io){return io->_pending;}
+
+int tina_io_register_buffers(tina_io* io, const struct iovec* iovecs, unsigned count){
+#ifdef _TINA_IO_URING
+	if(io->_backend == TINA_IO_BACKEND_URING){
+		return (int)_tina_io_errno(syscall(__NR_io_uring_register, io->_ring.fd, IORING_REGISTER_BUFFERS, iovecs, count));
+	}
+#endif
+	return 0;
+}
+
+unsigned tina_io_poll(tina_io* io, bool wait){
+	// Don't block if there is nothing to wait for, or if coroutines are already waiting to run.
+	wait = wait && io->_pending && !io->_completed_head;
+
+#ifdef _TINA_IO_URING
+	if(io->_backend == TINA_IO_BACKEND_URING) _tina_io_uring_poll(io, wait);
+#endif
+	if(io->_backend == TINA_IO_BACKEND_EPOLL) _tina_io_epoll_poll(io, wait);
+
+	// Take the completed list first since resumed coroutines may complete more operations immediately.
+	_tina_io_op* op = io->_completed_head;
+	io->_completed_head = io->_completed_tail = NULL;
+
+	unsigned resumed = 0;
+	while(op){
+		// The op is on the coroutine's stack, so read everything out before resuming it.
+		_tina_io_op* next = op->next;
+		io->_pending--;
+		tina_resume(op->coro, (void*)op->result);
+		resumed++;
+		op = next;
+	}
+
+	return resumed;
+}
+
+static intptr_t _tina_io_submit(tina_io* io, tina* coro, _tina_io_op* op){
+	op->coro = coro;
+	io->_pending++;
+
+#ifdef _TINA_IO_URING
+	if(io->_backend == TINA_IO_BACKEND_URING) _tina_io_uring_submit(io, op);
+#endif
+	if(io->_backend == TINA_IO_BACKEND_EPOLL) _tina_io_epoll_submit(io, op);
+
+	return (intptr_t)tina_yield(coro, NULL);
+}
+
+ssize_t tina_io_read(tina_io* io, tina* coro, int fd, void* buf, size_t len){
+	_tina_io_op op = {.opcode = _TINA_IO_READ, .fd = fd, .buf = buf, .len = len};
+	return _tina_io_submit(io, coro, &op);
+}
+
+ssize_t tina_io_write(tina_io* io, tina* coro, int fd, const void* buf, size_t len){
+	_tina_io_op op = {.opcode = _TINA_IO_WRITE, .fd = fd, .buf = (void*)buf, .len = len};
+	return _tina_io_submit(io, coro, &op);
+}
+
+ssize_t tina_io_read_fixed(tina_io* io, tina* coro, int fd, void* buf, size_t len, unsigned buf_index){
+	_tina_io_op op = {.opcode = _TINA_IO_READ_FIXED, .fd = fd, .buf = buf, .len = len, .buf_index = buf_index};
+	return _tina_io_submit(io, coro, &op);
+}
+
+ssize_t tina_io_write_fixed(tina_io* io, tina* coro, int fd, const void* buf, size_t len, unsigned buf_index){
+	_tina_io_op op = {.opcode = _TINA_IO_WRITE_FIXED, .fd = fd, .buf = (void*)buf, .len = len, .buf_index = buf_index};
+	return _tina_io_submit(io, coro, &op);
+}
+
+int tina_io_accept(tina_io* io, tina* coro, int fd, struct sockaddr* addr, socklen_t* addrlen){
+	_tina_io_op op = {.opcode = _TINA_IO_ACCEPT, .fd = fd, .buf = addr, .addrlen = addrlen};
+	return (int)_tina_io_submit(io, coro, &op);
+}
+
+#if defined(TINA_JOBS_H) && defined(TINA_JOBS_IMPLEMENTATION)
+
+typedef struct _tina_jobs_io_op _tina_jobs_io_op;
+struct _tina_jobs_io_op {
+	tina_jobs_io* io;
+	tina_job* job;
+	_tina_jobs_io_op* next;
+	int opcode, fd;
+	void* buf;
+	size_t len;
+	uint64_t offset;
+	intptr_t result;
+};
+
+struct tina_jobs_io {
+	tina_scheduler* _sched;
+	_TINA_MUTEX_T _lock;
+	// Is a thread blocked in the kernel waiting for completions?
+	bool _polling;
+#ifdef _TINA_IO_URING
+	_tina_io_ring _ring;
+#endif
+};
+
+tina_jobs_io* tina_jobs_io_new(tina_scheduler* sched, unsigned entries){
+	_TINA_ASSERT(!sched->_io, "Tina Jobs Error: Scheduler already has an I/O ring.");
+#ifdef _TINA_IO_URING
+	tina_jobs_io* io = (tina_jobs_io*)calloc(1, sizeof(tina_jobs_io));
+	const unsigned required[] = {IORING_OP_NOP, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC};
+	if(!io || !_tina_io_ring_init(&io->_ring, entries ? entries : 256, required, sizeof(required)/sizeof(*required))){
+		free(io);
+		return NULL;
+	}
+
+	io->_sched = sched;
+	_TINA_MUTEX_INIT(io->_lock);
+	sched->_io = io;
+	return io;
+#else
+	return NULL;
+#endif
+}
+
+void tina_jobs_io_free(tina_jobs_io* io){
+#ifdef _TINA_IO_URING
+	io->_sched->_io = NULL;
+	_tina_io_ring_destroy(&io->_ring);
+	_TINA_MUTEX_DESTROY(io->_lock);
+	free(io);
+#endif
+}
+
+#ifdef _TINA_IO_URING
+// Move completed requests onto 'list'. The lock must be held. Returns the number of requests moved.
+static unsigned _tina_jobs_io_reap(tina_jobs_io* io, _tina_jobs_io_op** list){
+	_tina_io_ring* ring = &io->_ring;
+	unsigned count = 0;
+	unsigned head = *ring->cq_head;
+	unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+	for(; head != tail; head++){
+		struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+		_tina_jobs_io_op* op = (_tina_jobs_io_op*)(uintptr_t)cqe->user_data;
+		// Interrupts don't have an op.
+		if(op == NULL) continue;
+		
+		op->result = cqe->res;
+		op->next = *list;
+		*list = op;
+		count++;
+	}
+	__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+	return count;
+}
+
+// Re-enqueue the jobs for a list of completed requests. Call without the lock held.
+static void _tina_jobs_io_unpark(_tina_jobs_io_op* completed){
+	while(completed){
+		// The op is on the job's stack, so read it before the job can run again.
+		_tina_jobs_io_op* next = completed->next;
+		tina_job_unpark(completed->job);
+		completed = next;
+	}
+}
+
+// Flush the submission queue until there's room for another entry. The lock must be held since only one thread can submit at a time.
+// The kernel refuses new entries while the completion queue is overflowing, so those are reaped onto 'list' to make room.
+// Returns 0 or a negative errno value.
+static int _tina_jobs_io_reserve(tina_jobs_io* io, _tina_jobs_io_op** list){
+	_tina_io_ring* ring = &io->_ring;
+	while(_tina_io_ring_full(ring)){
+		int submitted = _tina_io_ring_submit(ring, 0);
+		if(submitted == -EBUSY || submitted == -EAGAIN || submitted == -EINTR){
+			_tina_jobs_io_reap(io, list);
+		} else if(submitted <= 0){
+			return submitted < 0 ? submitted : -EBUSY;
+		}
+	}
+	return 0;
+}
+
+// Runs on the worker after the job's fiber switched out, so the completion can't resume it too early.
+static void _tina_jobs_io_park(tina_job* job, void* ctx){
+	_tina_jobs_io_op* op = (_tina_jobs_io_op*)ctx;
+	tina_jobs_io* io = op->io;
+	_tina_jobs_io_op* completed = NULL;
+	_TINA_MUTEX_LOCK(io->_lock); {
+		_tina_io_ring* ring = &io->_ring;
+		int err = _tina_jobs_io_reserve(io, &completed);
+		if(err){
+			// Fail the request instead of overwriting an entry the kernel hasn't seen yet.
+			op->result = err;
+			op->next = completed;
+			completed = op;
+		} else {
+			struct io_uring_sqe* sqe = _tina_io_ring_next_sqe(ring);
+			switch(op->opcode){
+				case _TINA_IO_READ: sqe->opcode = IORING_OP_READ; break;
+				case _TINA_IO_WRITE: sqe->opcode = IORING_OP_WRITE; break;
+				case _TINA_IO_FSYNC: sqe->opcode = IORING_OP_FSYNC; break;
+			}
+			sqe->fd = op->fd;
+			sqe->addr = (uintptr_t)op->buf;
+			sqe->len = (uint32_t)op->len;
+			sqe->off = op->offset;
+			sqe->user_data = (uintptr_t)op;
+			_tina_io_ring_commit(ring);
+			
+			// A blocked poller won't see new requests, so submit them now instead of waiting for the next batch.
+			if(io->_polling) _tina_io_ring_submit(ring, 0);
+		}
+	} _TINA_MUTEX_UNLOCK(io->_lock);
+	
+	_tina_jobs_io_unpark(completed);
+}
+#endif
+
+unsigned tina_jobs_io_poll(tina_jobs_io* io, bool wait){
+	unsigned count = 0;
+#ifdef _TINA_IO_URING
+	_tina_io_ring* ring = &io->_ring;
+	
+	// Submit the batch with the lock held so it can't race with a worker flushing a full ring.
+	_TINA_MUTEX_LOCK(io->_lock);
+	_tina_io_ring_submit(ring, 0);
+	io->_polling = wait;
+	_TINA_MUTEX_UNLOCK(io->_lock);
+	
+	// Only wait in the kernel without the lock. Requests queued in the meantime are submitted by the workers.
+	if(wait) _tina_io_ring_enter(ring, 0, 1);
+	
+	_tina_jobs_io_op* completed = NULL;
+	_TINA_MUTEX_LOCK(io->_lock); {
+		io->_polling = false;
+		count = _tina_jobs_io_reap(io, &completed);
+	} _TINA_MUTEX_UNLOCK(io->_lock);
+	
+	_tina_jobs_io_unpark(completed);
+#endif
+	return count;
+}
+
+void tina_jobs_io_interrupt(tina_jobs_io* io){
+#ifdef _TINA_IO_URING
+	_tina_jobs_io_op* completed = NULL;
+	_TINA_MUTEX_LOCK(io->_lock); {
+		_tina_io_ring* ring = &io->_ring;
+		if(_tina_jobs_io_reserve(io, &completed) == 0){
+			struct io_uring_sqe* sqe = _tina_io_ring_next_sqe(ring);
+			sqe->opcode = IORING_OP_NOP;
+			_tina_io_ring_commit(ring);
+		}
+		
+		_tina_io_ring_submit(ring, 0);
+	} _TINA_MUTEX_UNLOCK(io->_lock);
+	
+	_tina_jobs_io_unpark(completed);
+#endif
+}
+
+static intptr_t _tina_jobs_io_request(tina_job* job, _tina_jobs_io_op* op){
+#ifdef _TINA_IO_URING
+	tina_jobs_io* io = (tina_jobs_io*)tina_job_get_scheduler(job)->_io;
+	if(io){
+		op->io = io;
+		op->job = job;
+		tina_job_park(job, _tina_jobs_io_park, op);
+		return op->result;
+	}
+#endif
+	
+	// No ring, so just block.
+	switch(op->opcode){
+		case _TINA_IO_READ: return _tina_io_errno(pread(op->fd, op->buf, op->len, (off_t)op->offset));
+		case _TINA_IO_WRITE: return _tina_io_errno(pwrite(op->fd, op->buf, op->len, (off_t)op->offset));
+		default: return _tina_io_errno(fsync(op->fd));
+	}
+}
+
+ssize_t tina_job_read(tina_job* job, int fd, void* buf, size_t len, uint64_t offset){
+	_tina_jobs_io_op op = {.opcode = _TINA_IO_READ, .fd = fd, .buf = buf, .len = len, .offset = offset};
+	return _tina_jobs_io_request(job, &op);
+}
+
+ssize_t tina_job_write(tina_job* job, int fd, const void* buf, size_t len, uint64_t offset){
+	_tina_jobs_io_op op = {.opcode = _TINA_IO_WRITE, .fd = fd, .buf = (void*)buf, .len = len, .offset = offset};
+	return _tina_jobs_io_request(job, &op);
+}
+
+int tina_job_fsync(tina_job* job, int fd){
+	_tina_jobs_io_op op = {.opcode = _TINA_IO_FSYNC, .fd = fd};
+	return (int)_tina_jobs_io_request(job, &op);
+}
+
+#endif
+
+#endif // TINA_IO_IMPLEMENTATION
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // TINA_IO_H
@@ -31,6 +31,12 @@ typedef struct {
 	uintptr_t user_idx;
 	// Index of the queue to run the job on.
 	unsigned queue_idx;
+	// Deadline in tina_scheduler_now() time. Orders jobs in TINA_QUEUE_DEADLINE queues. (optional, 0 for none)
+	uint64_t deadline;
+	// Priority level for TINA_QUEUE_PRIORITY queues. 0 is the highest. (optional)
+	unsigned priority;
+	// Stack class to run the job's fiber from. (optional, 0 for the queue's default, see tina_scheduler_add_stack_class())
+	unsigned stack_class;
 } tina_job_description;
 
 // Get the scheduler for a job.
@@ -63,6 +69,103 @@ void tina_scheduler_free(tina_scheduler* sched);
 // Link a pair of queues for job prioritization. When the 'queue_idx' is empty it will steal jobs from 'fallback_idx'.
 void tina_scheduler_queue_priority(tina_scheduler* sched, unsigned queue_idx, unsigned fallback_idx);
 
+typedef enum {
+	TINA_QUEUE_FIFO, // Run jobs in the order they are enqueued. (default)
+	TINA_QUEUE_DEADLINE, // Run jobs with the earliest 'deadline' first. Jobs without one run last.
+	TINA_QUEUE_PRIORITY, // Run jobs with the highest 'priority' first, but age waiting jobs so low priorities can't starve.
+} tina_queue_mode;
+
+// Change how a queue orders it's jobs. The queue must be empty.
+void tina_scheduler_queue_mode(tina_scheduler* sched, unsigned queue_idx, tina_queue_mode mode);
+// Set how long a job must wait in a TINA_QUEUE_PRIORITY queue to catch up with a job one priority level higher. (default 1 ms)
+// A job with priority 'p' runs before any job that is enqueued more than 'p*aging_ns' after it, which bounds it's wait time.
+void tina_scheduler_queue_aging(tina_scheduler* sched, unsigned queue_idx, uint64_t aging_ns);
+
+// Set how long jobs in a queue may run before tina_job_check_yield() asks them to yield. (default 0, disabled)
+// Time slices are measured with a coarse clock that only advances when tina_scheduler_update_timeslices() is called.
+void tina_scheduler_queue_timeslice(tina_scheduler* sched, unsigned queue_idx, uint64_t slice_ns);
+// Advance the time slice clock. Call it periodically from any thread, ex: a watchdog thread or once per frame.
+// Slices are only as precise as the period this is called with.
+void tina_scheduler_update_timeslices(tina_scheduler* sched);
+
+// Keep the job most recently enqueued by a worker running this queue in a private slot on that worker, and run it next.
+// This keeps producer/consumer chains on one core while their data is still in it's cache. Only used by tina_scheduler_run() on FIFO queues.
+// 'max_streak' is how many jobs in a row a worker can take from it's slot before it must take one from the shared queue. (default 0, disabled)
+// Idle workers can still steal jobs from the slot, so they can't get stuck behind a long running job.
+void tina_scheduler_queue_runnext(tina_scheduler* sched, unsigned queue_idx, unsigned max_streak);
+
+typedef enum {
+	TINA_AFFINITY_NONE, // Woken jobs go to the back of the shared queue. (default)
+	TINA_AFFINITY_PREFER, // Woken jobs go back to the worker they last ran on, but idle workers can steal them.
+	TINA_AFFINITY_STRICT, // Woken jobs only resume on the worker they last ran on, unless it stopped running the queue.
+} tina_affinity_mode;
+
+// Set where jobs in a FIFO queue resume after tina_job_wait(). Resuming on the same worker keeps the fiber's stack and working set in that core's cache.
+// Only workers in tina_scheduler_run() have local queues. Jobs whose worker is gone go to the shared queue.
+void tina_scheduler_queue_affinity(tina_scheduler* sched, unsigned queue_idx, tina_affinity_mode mode);
+
+// When a job running in tina_scheduler_run() wakes a job waiting in the same queue, run the woken job next on the same worker instead of enqueuing it.
+// Skips a trip through the queue on fork/join critical paths, ex: when the last child job finishes. (default false)
+void tina_scheduler_queue_handoff(tina_scheduler* sched, unsigned queue_idx, bool enabled);
+// Let jobs in the queue run their group's queued jobs nested on their own fiber while they wait in tina_job_wait(). (0 to disable, the default)
+// Nesting stops after 'max_depth' levels, so make sure the stack size is big enough for that many jobs. Saves fibers in deep fork/join trees.
+void tina_scheduler_queue_help(tina_scheduler* sched, unsigned queue_idx, unsigned max_depth);
+
+// Hibernate jobs waiting in tina_job_wait() by copying the used part of their stack aside, so their fiber can run other jobs.
+// The longest waiting job is hibernated when fewer than 'reserve' fibers are free, or once it's waited 'min_age' ns. (0 to disable either)
+// Stacks can't be moved, so a job wakes on the same fiber and may have to wait for it. Parked jobs are never hibernated,
+// except for jobs parked in tina_job_enqueue_batch() while the job pool is full, so they can't hold a fiber a woken job needs.
+// NOTE: Jobs must not share memory on their stacks while waiting or yielding. That includes the groups they wait on!
+// Call before running any jobs. Requires the CRT, or _TINA_JOBS_ALLOC()/_TINA_JOBS_FREE() to be defined.
+void tina_scheduler_hibernation(tina_scheduler* sched, unsigned reserve, uint64_t min_age);
+
+// Let the job and fiber pools grow when they run out, up to 'max_jobs' and 'max_fibers' in total.
+// They grow in chunks the size of the initial pools, and jobs and fibers never move once they are allocated.
+// A grown chunk is freed once all of it's jobs or fibers are back in the pools and they haven't grown for 'shrink_delay' ns.
+// The pools are checked when the last job finishes, and when a worker running in TINA_RUN_LOOP mode goes idle.
+// Requires the CRT, or _TINA_JOBS_ALLOC()/_TINA_JOBS_FREE() to be defined.
+void tina_scheduler_growth(tina_scheduler* sched, unsigned max_jobs, unsigned max_fibers, uint64_t shrink_delay);
+
+// Get the allocation size for an extra pool of fibers with a different stack size. (see tina_scheduler_add_stack_class())
+size_t tina_stack_class_size(unsigned fiber_count, size_t stack_size);
+// Add a pool of fibers with a different stack size using memory from tina_stack_class_size(). The memory must outlive the scheduler.
+// Returns the index to use for tina_job_description.stack_class. Class 0 is the pool the scheduler was created with.
+// Ex: Keep small stacks for most jobs, and only give big ones to the few jobs that need them.
+// Call before running any jobs. Only class 0 grows with tina_scheduler_growth().
+unsigned tina_scheduler_add_stack_class(tina_scheduler* sched, void* buffer, unsigned fiber_count, size_t stack_size);
+#ifndef TINA_NO_CRT
+// Convenience method. Allocate and add a stack class. It's freed by tina_scheduler_free().
+unsigned tina_scheduler_new_stack_class(tina_scheduler* sched, unsigned fiber_count, size_t stack_size);
+#endif
+// Set the stack class for jobs in a queue that don't pick one in their description. (default 0)
+// Waiting jobs only help with jobs that need the same or a smaller stack. (see tina_scheduler_queue_help())
+void tina_scheduler_queue_stack_class(tina_scheduler* sched, unsigned queue_idx, unsigned stack_class);
+
+// Set which idle fibers tina_scheduler_trim_stacks() trims. (disabled by default)
+// The 'keep_fibers' most recently used fibers in each pool are left alone since they will run next.
+// The rest only keep 'keep_bytes' of stack below the idle fiber's own frame, and the pages past that are released.
+void tina_scheduler_stack_trimming(tina_scheduler* sched, unsigned keep_fibers, size_t keep_bytes);
+// Release the cold part of idle fibers' stacks back to the OS, so memory use drops again after a spike in load.
+// Call it periodically from any thread, ex: once per second from a watchdog thread. Returns the number of bytes released.
+// Fibers are only trimmed once until they run again. Uses madvise() on Linux, and does nothing elsewhere.
+// NOTE: Released pages read back as zeros, so fiber memory must be private, ex: from malloc() or mmap().
+size_t tina_scheduler_trim_stacks(tina_scheduler* sched);
+// Get how many bytes of the fiber stacks are resident in memory. Uses mincore() on Linux, and counts the whole stacks elsewhere.
+size_t tina_scheduler_stack_resident(tina_scheduler* sched);
+
+// Deadline accounting for jobs that complete in a queue.
+typedef struct {
+	// Number of jobs with a deadline that completed.
+	uint64_t completed;
+	// Number of jobs that completed after their deadline.
+	uint64_t missed;
+	// Worst lateness in nanoseconds.
+	uint64_t max_lateness;
+} tina_queue_stats;
+
+// Get the deadline accounting for a queue, and optionally reset it.
+tina_queue_stats tina_scheduler_queue_stats(tina_scheduler* sched, unsigned queue_idx, bool reset);
+
 typedef enum {
 	TINA_RUN_LOOP, // Run jobs from a queue until tina_scheduler_interrupt() is called.
 	TINA_RUN_FLUSH, // Run jobs from a queue until empty, or until all remaing jobs are waiting.
@@ -71,21 +174,108 @@ typedef enum {
 
 // Run jobs in the given queue based on the mode, returns false if no jobs were run.
 bool tina_scheduler_run(tina_scheduler* sched, unsigned queue_idx, tina_run_mode mode);
+// Run jobs in the given queue until it's empty, 'max_jobs' have run, or tina_scheduler_now() reaches 'deadline'. Remaining jobs are left queued.
+// The clock is checked before starting each job, so a long job can still overrun the deadline. Pass 0 to disable either limit.
+// Returns the number of jobs run. Ex: Cap the time spent on a serial graphics queue each frame.
+unsigned tina_scheduler_run_budget(tina_scheduler* sched, unsigned queue_idx, uint64_t deadline, unsigned max_jobs);
 // Interrupt TINA_RUN_LOOP execution of a queue on all active threads as soon as their current jobs finish.
+// Threads that haven't entered tina_scheduler_run() yet aren't interrupted. (see tina_scheduler_queue_workers())
 void tina_scheduler_interrupt(tina_scheduler* sched, unsigned queue_idx);
+// Get the number of threads currently in tina_scheduler_run() for a queue.
+// Ex: Wait for it to reach the number of worker threads you started before interrupting them.
+unsigned tina_scheduler_queue_workers(tina_scheduler* sched, unsigned queue_idx);
+
+// Opaque type for a set of queues that share workers in proportion to their weights.
+// Sets use deficit round robin. Each turn a queue earns time in proportion to it's weight, and is charged for the time it's jobs run.
+// Queues without work don't bank time, so their share is spread over the busy queues.
+typedef struct tina_queue_set tina_queue_set;
+
+// Get the allocation size for a queue set.
+size_t tina_queue_set_size(unsigned count);
+// Initialize memory for a set of 'count' queues with the given weights. A queue can only belong to one set.
+tina_queue_set* tina_queue_set_init(void* buffer, tina_scheduler* sched, const unsigned* queue_idxs, const unsigned* weights, unsigned count);
+// Destroy a queue set. Workers must not be running it.
+void tina_queue_set_destroy(tina_scheduler* sched, tina_queue_set* set);
+
+#ifndef TINA_NO_CRT
+// Convenience constructor. Allocate and initialize a queue set.
+tina_queue_set* tina_queue_set_new(tina_scheduler* sched, const unsigned* queue_idxs, const unsigned* weights, unsigned count);
+// Convenience destructor. Destroy and free a queue set.
+void tina_queue_set_free(tina_scheduler* sched, tina_queue_set* set);
+#endif
+
+// Change the weight of a queue in a set. Safe to call while workers are running the set.
+void tina_scheduler_set_weight(tina_scheduler* sched, tina_queue_set* set, unsigned queue_idx, unsigned weight);
+// Like tina_scheduler_run(), but share the workers between the queues in a set.
+bool tina_scheduler_run_set(tina_scheduler* sched, tina_queue_set* set, tina_run_mode mode);
+// Interrupt TINA_RUN_LOOP execution of a queue set.
+void tina_scheduler_interrupt_set(tina_scheduler* sched, tina_queue_set* set);
+
+// Opaque type for a list of queues a worker subscribes to.
+// Unlike a fallback chain, a queue can be in any number of subscriptions, and each one can order the queues differently.
+// Ex: A graphics thread can subscribe to {GFX, WORK} while the general workers subscribe to {IO, WORK}.
+typedef struct tina_subscription tina_subscription;
+
+// Get the allocation size for a subscription.
+size_t tina_subscription_size(unsigned count);
+// Initialize memory for a subscription to 'count' queues. Jobs are taken from the first queue in the list that has any.
+tina_subscription* tina_subscription_init(void* buffer, tina_scheduler* sched, const unsigned* queue_idxs, unsigned count);
+// Destroy a subscription. Workers must not be running it.
+void tina_subscription_destroy(tina_scheduler* sched, tina_subscription* sub);
+
+#ifndef TINA_NO_CRT
+// Convenience constructor. Allocate and initialize a subscription.
+tina_subscription* tina_subscription_new(tina_scheduler* sched, const unsigned* queue_idxs, unsigned count);
+// Convenience destructor. Destroy and free a subscription.
+void tina_subscription_free(tina_scheduler* sched, tina_subscription* sub);
+#endif
+
+// Like tina_scheduler_run(), but run jobs from the queues in a subscription. Enqueuing to any of them will wake the worker.
+bool tina_scheduler_run_subscription(tina_scheduler* sched, tina_subscription* sub, tina_run_mode mode);
+// Interrupt TINA_RUN_LOOP execution of a subscription.
+void tina_scheduler_interrupt_subscription(tina_scheduler* sched, tina_subscription* sub);
 
 // Add jobs to the scheduler, optionally pass the address of a tina_group to track when the jobs have completed.
 // If 'max_group_count' is non-zero, then 'count' will be adjusted based on the number of jobs already in the group.
 // Returns the number of jobs added.
 unsigned tina_scheduler_enqueue_batch(tina_scheduler* sched, const tina_job_description* list, unsigned count, tina_group* group, unsigned max_group_count);
+// Like tina_scheduler_enqueue_batch(), but only adds as many jobs as are left in the pool instead of aborting when it runs out.
+unsigned tina_scheduler_try_enqueue_batch(tina_scheduler* sched, const tina_job_description* list, unsigned count, tina_group* group, unsigned max_group_count);
 // Add many jobs to the scheduler that share the same description, but use sequential indexes.
 // It will schedule 'count' jobs with indexes from 0 to count - 1.
 void tina_scheduler_enqueue_n(tina_scheduler* sched, tina_job_func* func, void* user_data, unsigned count, unsigned queue_idx, tina_group* group);
+// Enqueue a job that won't start until 'wait_group' has 'threshold' or fewer remaining jobs. Optionally track it with 'group'.
+// Unlike tina_job_wait(), the job doesn't hold a fiber while it's waiting. If the group is already below the threshold it's enqueued immediately.
+void tina_scheduler_enqueue_after(tina_scheduler* sched, const tina_job_description* desc, tina_group* group, tina_group* wait_group, unsigned threshold);
+// Get the current time in nanoseconds from the monotonic clock used for timers and budgets. (see _TINA_TIME_NS())
+uint64_t tina_scheduler_now(tina_scheduler* sched);
+// Enqueue a job that won't start until 'deadline' (see tina_scheduler_now()). Optionally track it with 'group'.
+// Like tina_scheduler_enqueue_after(), the job doesn't hold a fiber until it starts.
+void tina_scheduler_enqueue_at(tina_scheduler* sched, const tina_job_description* desc, tina_group* group, uint64_t deadline);
+// Suspend the current job for at least 'ns' nanoseconds. Timers have a resolution of about a millisecond.
+// Workers running in TINA_RUN_LOOP mode sleep until the earliest deadline instead of polling.
+void tina_job_sleep(tina_job* job, uint64_t ns);
 // Yield the current job until the group has 'threshold' or fewer remaining jobs.
 // 'threshold' is useful to throttle a producer job. Allowing it to keep a consumers busy without a lot of queued items.
 unsigned tina_job_wait(tina_job* job, tina_group* group, unsigned threshold);
+// Enqueue jobs from inside of a job. If the job pool runs out, the current job is parked until other jobs finish.
+void tina_job_enqueue_batch(tina_job* job, const tina_job_description* list, unsigned count, tina_group* group);
 // Yield the current job and reschedule at the back of the queue.
 void tina_job_yield(tina_job* job);
+// Yield the current job only if it has used up it's time slice. (see tina_scheduler_queue_timeslice())
+// Cheap enough to call from a job's inner loop. Returns true if the job yielded.
+bool tina_job_check_yield(tina_job* job);
+// Yield the current job only if other jobs are waiting in it's queue, or in any higher priority queue linked with tina_scheduler_queue_priority().
+// Doesn't take the lock, so it's cheap to call often. Returns true if the job yielded.
+bool tina_job_yield_if_pending(tina_job* job);
+
+// Callback for tina_job_park(). Runs on the worker thread after the job's fiber has switched out.
+typedef void tina_job_park_func(tina_job* job, void* ctx);
+// Suspend the current job until something calls tina_job_unpark() on it. (ex: An I/O completion)
+// 'func' is called once the fiber has fully switched out, so from there it's safe to hand the job to another thread.
+void tina_job_park(tina_job* job, tina_job_park_func* func, void* ctx);
+// Push a parked job to the back of it's queue. Safe to call from any thread.
+void tina_job_unpark(tina_job* job);
 // Yield the current job and reschedule it at the back of a different queue.
 // Returns the old queue the job was scheduled on.
 unsigned tina_job_switch_queue(tina_job* job, unsigned queue_idx);
@@ -98,12 +288,45 @@ void tina_group_decrement(tina_scheduler* scheduler, tina_group* group, unsigned
 
 // Convenience method. Enqueue a single job.
 static inline void tina_scheduler_enqueue(tina_scheduler* sched, tina_job_func* func, void* user_data, uintptr_t user_idx, unsigned queue_idx, tina_group* group){
-	tina_job_description desc = {.name = NULL, .func = func, .user_data = user_data, .user_idx = user_idx, .queue_idx = queue_idx};
+	tina_job_description desc = {.name = NULL, .func = func, .user_data = user_data, .user_idx = user_idx, .queue_idx = queue_idx, .deadline = 0, .priority = 0, .stack_class = 0};
 	tina_scheduler_enqueue_batch(sched, &desc, 1, group, 0);
 }
 
 #ifdef TINA_JOBS_IMPLEMENTATION
 
+#include <string.h>
+#include <time.h>
+
+// Monotonic clock in nanoseconds used for timers, time slices, budgets and aging. Override if you need something else.
+#ifndef _TINA_TIME_NS
+#define _TINA_TIME_NS() _tina_time_ns()
+
+#if defined(_WIN32)
+#include <windows.h>
+
+static inline uint64_t _tina_time_ns(void){
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	uint64_t f = (uint64_t)freq.QuadPart, c = (uint64_t)count.QuadPart;
+	return (c/f)*1000000000 + (c%f)*1000000000/f;
+}
+#elif defined(CLOCK_MONOTONIC)
+static inline uint64_t _tina_time_ns(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+#else
+// No monotonic clock, so changing the system time makes timers fire early or late.
+static inline uint64_t _tina_time_ns(void){
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+#endif
+#endif
+
 // Override these. Based on C11 primitives.
 // Save yourself some trouble and grab https://github.com/tinycthread/tinycthread
 #ifndef _TINA_MUTEX_T
@@ -118,6 +341,58 @@ static inline void tina_scheduler_enqueue(tina_scheduler* sched, tina_job_func*
 #define _TINA_COND_WAIT(_SIG_, _LOCK_) cnd_wait(&_SIG_, &_LOCK_);
 #define _TINA_COND_SIGNAL(_SIG_) cnd_signal(&_SIG_)
 #define _TINA_COND_BROADCAST(_SIG_) cnd_broadcast(&_SIG_)
+// Wait until signaled or the absolute _TINA_TIME_NS() deadline passes. Must evaluate to true if it timed out.
+// Optional when overriding the others, but idle workers will poll while timers are pending without it.
+#define _TINA_COND_TIMEDWAIT(_SIG_, _LOCK_, _DEADLINE_) _tina_cond_timedwait(&_SIG_, &_LOCK_, _DEADLINE_)
+
+// cnd_timedwait() takes a TIME_UTC deadline, so convert the time remaining on the monotonic clock.
+static inline bool _tina_cond_timedwait(cnd_t* sig, mtx_t* lock, uint64_t deadline){
+	uint64_t now = _TINA_TIME_NS(), remaining = (deadline > now ? deadline - now : 0);
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	uint64_t nsec = (uint64_t)ts.tv_nsec + remaining%1000000000;
+	ts.tv_sec += (time_t)(remaining/1000000000 + nsec/1000000000);
+	ts.tv_nsec = (long)(nsec%1000000000);
+	return cnd_timedwait(sig, lock, &ts) == thrd_timedout;
+}
+#endif
+
+#ifndef _TINA_COND_TIMEDWAIT
+#define _TINA_COND_TIMEDWAIT(_SIG_, _LOCK_, _DEADLINE_) _tina_cond_poll(&_LOCK_)
+
+// Fallback that only gives other threads a chance to take the lock, and reports a timeout so the caller checks the time again.
+static bool _tina_cond_poll(_TINA_MUTEX_T* lock){
+	_TINA_MUTEX_UNLOCK(*lock);
+	_TINA_MUTEX_LOCK(*lock);
+	return true;
+}
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define _TINA_CTZ64(_X_) __builtin_ctzll(_X_)
+#else
+static inline unsigned _tina_ctz64(uint64_t x){unsigned n = 0; while(!(x & 1)){x >>= 1; n++;} return n;}
+#define _TINA_CTZ64(_X_) _tina_ctz64(_X_)
+#endif
+
+#ifndef _TINA_THREAD_LOCAL
+#if defined(__cplusplus)
+#define _TINA_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define _TINA_THREAD_LOCAL __declspec(thread)
+#else
+#define _TINA_THREAD_LOCAL _Thread_local
+#endif
+#endif
+
+#ifndef _TINA_NOINLINE
+#if defined(_MSC_VER)
+#define _TINA_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define _TINA_NOINLINE __attribute__((noinline))
+#else
+#define _TINA_NOINLINE
+#endif
 #endif
 
 #ifndef _TINA_PROFILE_ENTER
@@ -125,13 +400,75 @@ static inline void tina_scheduler_enqueue(tina_scheduler* sched, tina_job_func*
 #define _TINA_PROFILE_LEAVE(_JOB_, _STATUS_)
 #endif
 
+// Allocator for hibernated stacks and grown pools.
+#ifndef _TINA_JOBS_ALLOC
+	#ifndef TINA_NO_CRT
+		#define _TINA_JOBS_ALLOC(_SIZE_) malloc(_SIZE_)
+		#define _TINA_JOBS_FREE(_PTR_) free(_PTR_)
+	#else
+		#define _TINA_JOBS_ALLOC(_SIZE_) NULL
+		#define _TINA_JOBS_FREE(_PTR_)
+	#endif
+#endif
+
+// Release whole pages of an idle fiber's stack and return true on success, and count the resident bytes in a page aligned range.
+#ifndef _TINA_PAGES_RELEASE
+	#if defined(__linux__)
+		#include <sys/mman.h>
+		#include <unistd.h>
+		#define _TINA_PAGE_SIZE() ((size_t)sysconf(_SC_PAGESIZE))
+		#define _TINA_PAGES_RELEASE(_ADDR_, _SIZE_) (madvise(_ADDR_, _SIZE_, MADV_DONTNEED) == 0)
+		#define _TINA_PAGES_RESIDENT(_ADDR_, _SIZE_) _tina_pages_resident(_ADDR_, _SIZE_)
+		
+		static size_t _tina_pages_resident(void* addr, size_t size){
+			size_t page_size = _TINA_PAGE_SIZE(), resident = 0;
+			unsigned char vec[256];
+			for(uint8_t* cursor = (uint8_t*)addr; size; ){
+				size_t block = size < sizeof(vec)*page_size ? size : sizeof(vec)*page_size;
+				if(mincore(cursor, block, vec) != 0) return resident + size;
+				for(size_t i = 0; i < (block + page_size - 1)/page_size; i++) resident += (vec[i] & 1)*page_size;
+				cursor += block, size -= block;
+			}
+			return resident;
+		}
+	#else
+		#define _TINA_PAGE_SIZE() ((size_t)4096)
+		#define _TINA_PAGES_RELEASE(_ADDR_, _SIZE_) false
+		#define _TINA_PAGES_RESIDENT(_ADDR_, _SIZE_) (_SIZE_)
+	#endif
+#endif
+
+typedef struct _tina_worker _tina_worker;
+
 struct tina_job {
 	tina_job_description desc;
 	void* user_data;
 	tina* fiber;
 	tina_group* group;
 	tina_job* wait_next;
+	tina_group* wait_group;
 	unsigned wait_threshold;
+	tina_job_park_func* park_func;
+	void* park_ctx;
+	uint64_t timer_deadline;
+	// Sort key for ordered queues. Ties are broken by the order jobs were pushed.
+	uint64_t queue_key;
+	size_t queue_seq;
+	// Time slice clock value when the job resumed, and how many ticks it can run for. (0 for no limit)
+	uintptr_t slice_start, slice_length;
+	// Worker the job last ran on, if any. Only dereferenced while the job is running, otherwise it's only compared against running workers.
+	_tina_worker* last_worker;
+	// How many jobs deep this job is nested on a waiting job's fiber.
+	unsigned help_depth;
+	// Stack class of the pool the job's fiber came from.
+	unsigned stack_class;
+	// Copy of the fiber's header and used stack while the job is hibernated. It still owns 'fiber' as it's home.
+	void* hibernated;
+	// Links in the list of waiting jobs that can be hibernated.
+	tina_job* idle_prev;
+	tina_job* idle_next;
+	uint64_t idle_since;
+	bool idle;
 };
 
 tina_scheduler* tina_job_get_scheduler(tina_job* job){return (tina_scheduler*)job->fiber->user_data;}
@@ -142,11 +479,32 @@ typedef struct {
 	size_t count;
 } _tina_stack;
 
+typedef struct _tina_subscription_link _tina_subscription_link;
+
 // Simple power of two circular queues.
+// Ordered queues use 'arr' as a binary heap instead.
 typedef struct _tina_queue _tina_queue;
 struct _tina_queue{
 	void** arr;
 	size_t head, tail, mask;
+	tina_queue_mode mode;
+	size_t heap_count, heap_seq;
+	uint64_t aging;
+	uint64_t timeslice;
+	unsigned runnext_limit;
+	// Number of jobs waiting in the 'runnext' slots of this queue's workers.
+	unsigned runnext_count;
+	tina_affinity_mode affinity;
+	bool handoff;
+	unsigned help_depth;
+	unsigned stack_class;
+	// List of workers running this queue with tina_scheduler_run().
+	_tina_worker* workers;
+	tina_queue_stats stats;
+	// Set this queue is shared with, if any.
+	tina_queue_set* set;
+	// List of subscriptions that include this queue.
+	_tina_subscription_link* subscribers;
 	
 	// Higher priority queue in the chain. Used for signaling worker threads.
 	_tina_queue* parent;
@@ -159,27 +517,150 @@ struct _tina_queue{
 	unsigned interrupt_stamp;
 };
 
+// Hibernation state for each fiber.
+typedef struct {
+	// Job that the fiber's current stack belongs to, or NULL if it's in the pool.
+	tina_job* owner;
+	// The owner is running or parked, so it can't be hibernated.
+	bool busy;
+	// Hibernated jobs waiting for the owner to finish running, linked by 'wait_next'.
+	tina_job* deferred;
+	// The stack was trimmed since the fiber last ran. (see tina_scheduler_trim_stacks())
+	bool trimmed;
+	// Number of hibernated jobs that will wake up on this fiber.
+	unsigned hibernated;
+} _tina_fiber_info;
+
+// Jobs allocated together in one block when the pool grows.
+typedef struct _tina_job_chunk _tina_job_chunk;
+struct _tina_job_chunk {
+	_tina_job_chunk* next;
+	unsigned count;
+};
+
+// Fibers allocated together in one block.
+typedef struct _tina_fiber_chunk _tina_fiber_chunk;
+struct _tina_fiber_chunk {
+	uint8_t* base;
+	unsigned count;
+	_tina_fiber_info* info;
+	_tina_fiber_chunk* next;
+};
+
+typedef tina* _tina_fiber_factory(tina_scheduler* sched, unsigned fiber_idx, void* buffer, size_t stack_size, void* user_ptr);
+
+#ifndef _TINA_MAX_STACK_CLASSES
+#define _TINA_MAX_STACK_CLASSES 4
+#endif
+
+// Pool of fibers that share a stack size. (see tina_scheduler_add_stack_class())
+typedef struct {
+	// Keep the fibers in a stack so recently used ones are fresh in the cache.
+	_tina_stack fibers;
+	size_t stack_size;
+	// The initial fibers are the first chunk, and grown chunks are linked after it.
+	_tina_fiber_chunk chunks;
+	// Jobs that couldn't start because the pool was empty, linked by 'wait_next'.
+	tina_job* wait_head;
+	tina_job* wait_tail;
+	// Pool growth. (see tina_scheduler_growth()) The initial count is also the chunk size.
+	unsigned count, initial_count, max_count;
+	// Capacity of the 'fibers' array, and if it was moved to the heap.
+	size_t capacity;
+	bool grown;
+	// Memory allocated by tina_scheduler_new_stack_class(), if any.
+	void* owned;
+} _tina_fiber_pool;
+
+// Timers have a resolution of 2^20 ns, or about a millisecond. The 4 levels cover about 5 hours before they need to re-cascade.
+#define _TINA_TIMER_RESOLUTION 20
+#define _TINA_TIMER_BITS 6
+#define _TINA_TIMER_SLOTS (1 << _TINA_TIMER_BITS)
+#define _TINA_TIMER_MASK (_TINA_TIMER_SLOTS - 1)
+
+// Time slices have a resolution of 2^10 ns, or about a microsecond. The clock wraps around every ~70 minutes on 32 bit targets.
+#define _TINA_SLICE_RESOLUTION 10
+#define _TINA_TIMER_LEVELS 4
+
 struct tina_scheduler {
 	_TINA_MUTEX_T _lock;
 	
 	_tina_queue* _queues;
 	size_t _queue_count;
 	
-	// Keep the jobs and fiber pools in a stack so recently used items are fresh in the cache.
-	_tina_stack _fibers, _job_pool;
+	// Keep the job pool in a stack so recently used items are fresh in the cache.
+	_tina_stack _job_pool;
+	// Fiber pools for each stack class. Class 0 is allocated with the scheduler.
+	_tina_fiber_pool _stack_classes[_TINA_MAX_STACK_CLASSES];
+	unsigned _stack_class_count;
+	
+	// Optional I/O ring. (see tina_io.h)
+	void* _io;
+	
+	// Hierarchical timer wheel of sleeping jobs linked by 'wait_next'. Times are in ticks of 2^_TINA_TIMER_RESOLUTION ns.
+	tina_job* _timer_wheel[_TINA_TIMER_LEVELS][_TINA_TIMER_SLOTS];
+	// Bitmask of the non-empty slots in each level.
+	uint64_t _timer_occupied[_TINA_TIMER_LEVELS];
+	uint64_t _timer_tick;
+	unsigned _timer_count;
+	// The idle worker that is waiting for the next deadline, if any. Points at the semaphore it's waiting on.
+	_TINA_COND_T* _timer_keeper;
+	unsigned* _timer_keeper_count;
+	uint64_t _timer_keeper_deadline;
+	
+	// Coarse clock for time slices in ticks of 2^_TINA_SLICE_RESOLUTION ns. Written without the lock, so jobs can poll it cheaply.
+	// It's a single word so reads can't tear, and it's only compared using wrapping differences.
+	volatile uintptr_t _slice_clock;
+	
+	// Hibernation policy. (see tina_scheduler_hibernation())
+	bool _hibernate;
+	unsigned _hibernate_reserve;
+	uint64_t _hibernate_age;
+	// Waiting jobs that are holding a fiber, oldest first.
+	tina_job* _idle_head;
+	tina_job* _idle_tail;
+	
+	// Stack trimming policy. (see tina_scheduler_stack_trimming())
+	bool _trim;
+	unsigned _trim_keep_fibers;
+	size_t _trim_keep_bytes;
+	
+	// Jobs parked in tina_job_enqueue_batch() until the job pool has room, linked by 'wait_next'.
+	tina_job* _capacity_waiters;
+	
+	// Pool growth. (see tina_scheduler_growth()) The initial count is also the chunk size.
+	unsigned _job_count, _initial_job_count, _max_jobs;
+	uint64_t _shrink_delay, _last_growth;
+	// Initial jobs in the scheduler's buffer, and grown chunks of jobs linked by their first pointer.
+	uint8_t* _job_base;
+	_tina_job_chunk* _job_chunks;
+	// Capacity of the job pool and queue arrays, and if they were moved to the heap.
+	size_t _job_capacity;
+	bool _jobs_grown;
+	_tina_fiber_factory* _fiber_factory;
+	void* _factory_data;
 };
 
 typedef enum {
 	_TINA_STATUS_COMPLETED,
 	_TINA_STATUS_WAITING,
 	_TINA_STATUS_YIELDING,
+	_TINA_STATUS_PARKED,
 } _tina_job_status;
 
+// Jobs are aligned, so the status is packed into the low bits of the job pointer when yielding.
+// The fiber may be suspended by a job nested on it instead of the one that was resumed. (see tina_scheduler_queue_help())
+#define _TINA_STATUS_MASK 3
+
+static inline void _tina_job_suspend(tina_job* job, _tina_job_status status){
+	tina_yield(job->fiber, (void*)((uintptr_t)job | status));
+}
+
 static void* _tina_jobs_fiber(tina* fiber, void* value){
 	while(true){
 		tina_job* job = (tina_job*)value;
 		job->desc.func(job);
-		value = tina_yield(fiber, (void*)_TINA_STATUS_COMPLETED);
+		value = tina_yield(fiber, (void*)((uintptr_t)job | _TINA_STATUS_COMPLETED));
 	}
 	
 	return 0; // Unreachable.
@@ -193,28 +674,63 @@ size_t tina_scheduler_size(unsigned job_count, unsigned queue_count, unsigned fi
 	size += _tina_jobs_align(sizeof(tina_scheduler));
 	// Size of queues.
 	size += _tina_jobs_align(queue_count*sizeof(_tina_queue));
-	// Size of fiber pool array.
-	size += _tina_jobs_align(fiber_count*sizeof(void*));
 	// Size of job pool array.
 	size += _tina_jobs_align(job_count*sizeof(void*));
 	// Size of queue arrays.
 	size += queue_count*_tina_jobs_align(job_count*sizeof(void*));
 	// Size of jobs.
 	size += job_count*_tina_jobs_align(sizeof(tina_job));
+	// Size of the fiber pool.
+	size += tina_stack_class_size(fiber_count, stack_size);
+	return size;
+}
+
+size_t tina_stack_class_size(unsigned fiber_count, size_t stack_size){
+	size_t size = 0;
+	// Size of fiber pool array.
+	size += _tina_jobs_align(fiber_count*sizeof(void*));
+	// Size of fiber info array.
+	size += _tina_jobs_align(fiber_count*sizeof(_tina_fiber_info));
 	// Size of fibers.
 	size += fiber_count*stack_size;
 	return size;
 }
 
-typedef tina* _tina_fiber_factory(tina_scheduler* sched, unsigned fiber_idx, void* buffer, size_t stack_size, void* user_ptr);
-
 static tina* _tina_jobs_default_fiber_factory(tina_scheduler* sched, unsigned fiber_idx, void* buffer, size_t stack_size, void* factory_data){
 	return tina_init(buffer, stack_size, (tina_func*)factory_data, sched);
 }
 
+// Initialize a fiber pool in memory from tina_stack_class_size().
+static void _tina_fiber_pool_init(tina_scheduler* sched, _tina_fiber_pool* pool, void* buffer, unsigned fiber_count, size_t stack_size){
+	_TINA_ASSERT((stack_size & (stack_size - 1)) == 0, "Tina Jobs Error: Stack size must be a power of two.");
+	uint8_t* cursor = (uint8_t*)buffer;
+	
+	_tina_stack fibers = {.arr = (void**)cursor, .count = fiber_count};
+	pool->fibers = fibers;
+	cursor += _tina_jobs_align(fiber_count*sizeof(void*));
+	_tina_fiber_chunk chunk = {.base = NULL, .count = fiber_count, .info = (_tina_fiber_info*)cursor, .next = NULL};
+	pool->chunks = chunk;
+	cursor += _tina_jobs_align(fiber_count*sizeof(_tina_fiber_info));
+	
+	pool->stack_size = stack_size;
+	pool->wait_head = pool->wait_tail = NULL;
+	pool->count = pool->initial_count = pool->max_count = fiber_count;
+	pool->capacity = fiber_count;
+	pool->grown = false;
+	pool->owned = NULL;
+	
+	// Initialize the fibers and fill the pool.
+	pool->chunks.base = cursor;
+	for(unsigned i = 0; i < fiber_count; i++){
+		pool->fibers.arr[i] = sched->_fiber_factory(sched, i, cursor, stack_size, sched->_factory_data);
+		_tina_fiber_info info = {.owner = NULL, .busy = false, .deferred = NULL, .trimmed = false, .hibernated = 0};
+		pool->chunks.info[i] = info;
+		cursor += stack_size;
+	}
+}
+
 static tina_scheduler* _tina_scheduler_init2(void* buffer, unsigned job_count, unsigned queue_count, unsigned fiber_count, size_t stack_size, _tina_fiber_factory* fiber_factory, void* factory_data){
 	_TINA_ASSERT((job_count & (job_count - 1)) == 0, "Tina Jobs Error: Job count must be a power of two.");
-	_TINA_ASSERT((stack_size & (stack_size - 1)) == 0, "Tina Jobs Error: Stack size must be a power of two.");
 	uint8_t* cursor = (uint8_t*)buffer;
 	
 	// Sub allocate all of the memory for the various arrays.
@@ -222,9 +738,6 @@ static tina_scheduler* _tina_scheduler_init2(void* buffer, unsigned job_count, u
 	cursor += _tina_jobs_align(sizeof(tina_scheduler));
 	sched->_queues = (_tina_queue*)cursor;
 	cursor += _tina_jobs_align(queue_count*sizeof(_tina_queue));
-	_tina_stack fibers = {.arr = (void**)cursor, .count = 0};
-	sched->_fibers = fibers;
-	cursor += _tina_jobs_align(fiber_count*sizeof(void*));
 	_tina_stack job_pool = {.arr = (void**)cursor, .count = 0};
 	sched->_job_pool = job_pool;
 	cursor += _tina_jobs_align(job_count*sizeof(void*));
@@ -236,6 +749,21 @@ static tina_scheduler* _tina_scheduler_init2(void* buffer, unsigned job_count, u
 		queue->arr = (void**)cursor;
 		queue->head = queue->tail = 0;
 		queue->mask = job_count - 1;
+		queue->mode = TINA_QUEUE_FIFO;
+		queue->heap_count = queue->heap_seq = 0;
+		queue->aging = 1000000;
+		queue->timeslice = 0;
+		queue->runnext_limit = 0;
+		queue->runnext_count = 0;
+		queue->affinity = TINA_AFFINITY_NONE;
+		queue->handoff = false;
+		queue->help_depth = 0;
+		queue->stack_class = 0;
+		queue->workers = NULL;
+		tina_queue_stats stats = {.completed = 0, .missed = 0, .max_lateness = 0};
+		queue->stats = stats;
+		queue->set = NULL;
+		queue->subscribers = NULL;
 		queue->parent = queue->fallback = NULL;
 		_TINA_COND_INIT(queue->semaphore_signal);
 		queue->semaphore_count = 0;
@@ -244,18 +772,45 @@ static tina_scheduler* _tina_scheduler_init2(void* buffer, unsigned job_count, u
 	}
 	
 	// Fill the job pool.
+	sched->_job_base = cursor;
 	sched->_job_pool.count = job_count;
 	for(unsigned i = 0; i < job_count; i++){
 		sched->_job_pool.arr[i] = cursor;
 		cursor += _tina_jobs_align(sizeof(tina_job));
 	}
 	
-	// Initialize the fibers and fill the pool.
-	sched->_fibers.count = fiber_count;
-	for(unsigned i = 0; i < fiber_count; i++){
-		sched->_fibers.arr[i] = fiber_factory(sched, i, cursor, stack_size, factory_data);
-		cursor += stack_size;
-	}
+	// The rest of the buffer is the fiber pool for stack class 0.
+	sched->_fiber_factory = fiber_factory;
+	sched->_factory_data = factory_data;
+	_tina_fiber_pool_init(sched, &sched->_stack_classes[0], cursor, fiber_count, stack_size);
+	sched->_stack_class_count = 1;
+	
+	sched->_io = NULL;
+	
+	// Initialize the timer wheel.
+	memset(sched->_timer_wheel, 0, sizeof(sched->_timer_wheel));
+	memset(sched->_timer_occupied, 0, sizeof(sched->_timer_occupied));
+	sched->_timer_tick = 0;
+	sched->_timer_count = 0;
+	sched->_timer_keeper = NULL;
+	sched->_timer_keeper_count = NULL;
+	sched->_timer_keeper_deadline = 0;
+	sched->_slice_clock = 0;
+	
+	sched->_hibernate = false;
+	sched->_hibernate_reserve = 0;
+	sched->_hibernate_age = 0;
+	sched->_idle_head = sched->_idle_tail = NULL;
+	sched->_trim = false;
+	sched->_trim_keep_fibers = 0;
+	sched->_trim_keep_bytes = 0;
+	sched->_capacity_waiters = NULL;
+	
+	sched->_job_count = sched->_initial_job_count = sched->_max_jobs = job_count;
+	sched->_shrink_delay = sched->_last_growth = 0;
+	sched->_job_chunks = NULL;
+	sched->_job_capacity = job_count;
+	sched->_jobs_grown = false;
 	
 	_TINA_MUTEX_INIT(sched->_lock);
 	return sched;
@@ -267,7 +822,27 @@ tina_scheduler* tina_scheduler_init(void* buffer, unsigned job_count, unsigned q
 
 void tina_scheduler_destroy(tina_scheduler* sched){
 	_TINA_MUTEX_DESTROY(sched->_lock);
-	for(unsigned i = 0; i < sched->_queue_count; i++) _TINA_COND_DESTROY(sched->_queues[i].semaphore_signal);
+	for(unsigned i = 0; i < sched->_queue_count; i++){
+		_TINA_COND_DESTROY(sched->_queues[i].semaphore_signal);
+		if(sched->_jobs_grown) _TINA_JOBS_FREE(sched->_queues[i].arr);
+	}
+	
+	// Free any grown memory.
+	while(sched->_job_chunks){
+		_tina_job_chunk* chunk = sched->_job_chunks;
+		sched->_job_chunks = chunk->next;
+		_TINA_JOBS_FREE(chunk);
+	}
+	for(unsigned i = 0; i < sched->_stack_class_count; i++){
+		_tina_fiber_pool* pool = &sched->_stack_classes[i];
+		while(pool->chunks.next){
+			_tina_fiber_chunk* chunk = pool->chunks.next;
+			pool->chunks.next = chunk->next;
+			_TINA_JOBS_FREE(chunk);
+		}
+		if(pool->grown) _TINA_JOBS_FREE(pool->fibers.arr);
+	}
+	if(sched->_jobs_grown) _TINA_JOBS_FREE(sched->_job_pool.arr);
 }
 
 #ifndef TINA_NO_CRT
@@ -278,6 +853,7 @@ tina_scheduler* tina_scheduler_new(unsigned job_count, unsigned queue_count, uns
 
 void tina_scheduler_free(tina_scheduler* sched){
 	tina_scheduler_destroy(sched);
+	for(unsigned i = 0; i < sched->_stack_class_count; i++) free(sched->_stack_classes[i].owned);
 	free(sched);
 }
 #endif
@@ -297,9 +873,163 @@ void tina_scheduler_queue_priority(tina_scheduler* sched, unsigned queue_idx, un
 	fallback->parent = parent;
 }
 
+void tina_scheduler_queue_mode(tina_scheduler* sched, unsigned queue_idx, tina_queue_mode mode){
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		_tina_queue* queue = _tina_get_queue(sched, queue_idx);
+		_TINA_ASSERT(queue->head == queue->tail && queue->heap_count == 0, "Tina Jobs Error: Queue must be empty to change it's mode.");
+		queue->mode = mode;
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_queue_aging(tina_scheduler* sched, unsigned queue_idx, uint64_t aging_ns){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_get_queue(sched, queue_idx)->aging = aging_ns;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_queue_runnext(tina_scheduler* sched, unsigned queue_idx, unsigned max_streak){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_get_queue(sched, queue_idx)->runnext_limit = max_streak;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_queue_affinity(tina_scheduler* sched, unsigned queue_idx, tina_affinity_mode mode){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_get_queue(sched, queue_idx)->affinity = mode;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_queue_handoff(tina_scheduler* sched, unsigned queue_idx, bool enabled){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_get_queue(sched, queue_idx)->handoff = enabled;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_queue_help(tina_scheduler* sched, unsigned queue_idx, unsigned max_depth){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_get_queue(sched, queue_idx)->help_depth = max_depth;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_hibernation(tina_scheduler* sched, unsigned reserve, uint64_t min_age){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	sched->_hibernate = reserve || min_age;
+	sched->_hibernate_reserve = reserve;
+	sched->_hibernate_age = min_age;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_growth(tina_scheduler* sched, unsigned max_jobs, unsigned max_fibers, uint64_t shrink_delay){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	sched->_max_jobs = max_jobs > sched->_initial_job_count ? max_jobs : sched->_initial_job_count;
+	_tina_fiber_pool* pool = &sched->_stack_classes[0];
+	pool->max_count = max_fibers > pool->initial_count ? max_fibers : pool->initial_count;
+	sched->_shrink_delay = shrink_delay;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+unsigned tina_scheduler_add_stack_class(tina_scheduler* sched, void* buffer, unsigned fiber_count, size_t stack_size){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	unsigned stack_class = sched->_stack_class_count;
+	_TINA_ASSERT(stack_class < _TINA_MAX_STACK_CLASSES, "Tina Jobs Error: Too many stack classes. Increase _TINA_MAX_STACK_CLASSES.");
+	_tina_fiber_pool_init(sched, &sched->_stack_classes[stack_class], buffer, fiber_count, stack_size);
+	sched->_stack_class_count++;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+	return stack_class;
+}
+
+#ifndef TINA_NO_CRT
+unsigned tina_scheduler_new_stack_class(tina_scheduler* sched, unsigned fiber_count, size_t stack_size){
+	void* buffer = malloc(tina_stack_class_size(fiber_count, stack_size));
+	unsigned stack_class = tina_scheduler_add_stack_class(sched, buffer, fiber_count, stack_size);
+	sched->_stack_classes[stack_class].owned = buffer;
+	return stack_class;
+}
+#endif
+
+void tina_scheduler_queue_stack_class(tina_scheduler* sched, unsigned queue_idx, unsigned stack_class){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_TINA_ASSERT(stack_class < sched->_stack_class_count, "Tina Jobs Error: Invalid stack class.");
+	_tina_get_queue(sched, queue_idx)->stack_class = stack_class;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_stack_trimming(tina_scheduler* sched, unsigned keep_fibers, size_t keep_bytes){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	sched->_trim = true;
+	sched->_trim_keep_fibers = keep_fibers;
+	sched->_trim_keep_bytes = keep_bytes;
+	
+	// Fibers aren't tracked while trimming is disabled, so consider all of them again.
+	for(unsigned i = 0; i < sched->_stack_class_count; i++){
+		for(_tina_fiber_chunk* chunk = &sched->_stack_classes[i].chunks; chunk; chunk = chunk->next){
+			for(unsigned j = 0; j < chunk->count; j++) chunk->info[j].trimmed = false;
+		}
+	}
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_queue_timeslice(tina_scheduler* sched, unsigned queue_idx, uint64_t slice_ns){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_get_queue(sched, queue_idx)->timeslice = slice_ns;
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_scheduler_update_timeslices(tina_scheduler* sched){
+	sched->_slice_clock = (uintptr_t)(_TINA_TIME_NS() >> _TINA_SLICE_RESOLUTION);
+}
+
+tina_queue_stats tina_scheduler_queue_stats(tina_scheduler* sched, unsigned queue_idx, bool reset){
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_queue* queue = _tina_get_queue(sched, queue_idx);
+	tina_queue_stats stats = queue->stats;
+	if(reset){
+		tina_queue_stats zero = {.completed = 0, .missed = 0, .max_lateness = 0};
+		queue->stats = zero;
+	}
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+	return stats;
+}
+
+static inline bool _tina_job_before(const tina_job* a, const tina_job* b){
+	return a->queue_key < b->queue_key || (a->queue_key == b->queue_key && a->queue_seq < b->queue_seq);
+}
+
+static void _tina_heap_push(_tina_queue* queue, tina_job* job){
+	// Sift up.
+	size_t i = queue->heap_count++;
+	while(i > 0){
+		size_t parent = (i - 1)/2;
+		if(!_tina_job_before(job, (tina_job*)queue->arr[parent])) break;
+		queue->arr[i] = queue->arr[parent];
+		i = parent;
+	}
+	queue->arr[i] = job;
+}
+
+static tina_job* _tina_heap_pop(_tina_queue* queue){
+	tina_job* top = (tina_job*)queue->arr[0];
+	tina_job* last = (tina_job*)queue->arr[--queue->heap_count];
+	
+	// Sift the last job down from the root.
+	size_t count = queue->heap_count, i = 0;
+	while(true){
+		size_t child = 2*i + 1;
+		if(child >= count) break;
+		if(child + 1 < count && _tina_job_before((tina_job*)queue->arr[child + 1], (tina_job*)queue->arr[child])) child++;
+		if(!_tina_job_before((tina_job*)queue->arr[child], last)) break;
+		queue->arr[i] = queue->arr[child];
+		i = child;
+	}
+	queue->arr[i] = last;
+	return top;
+}
+
 static tina_job* _tina_queue_next_job(_tina_queue* queue){
 	if(queue->head != queue->tail){
 		return (tina_job*)queue->arr[queue->tail++ & queue->mask];
+	} else if(queue->heap_count){
+		return _tina_heap_pop(queue);
 	} else if(queue->fallback){
 		return _tina_queue_next_job(queue->fallback);
 	} else {
@@ -307,87 +1037,893 @@ static tina_job* _tina_queue_next_job(_tina_queue* queue){
 	}
 }
 
+// How many queued jobs tina_job_wait() searches for one it can help with.
+#ifndef _TINA_HELP_SEARCH
+#define _TINA_HELP_SEARCH 64
+#endif
+
+// Time in nanoseconds a queue earns per unit of weight each turn.
+#ifndef _TINA_QUEUE_SET_QUANTUM
+#define _TINA_QUEUE_SET_QUANTUM 100000
+#endif
+
+typedef struct {
+	_tina_queue* queue;
+	unsigned weight;
+	// Time in nanoseconds the queue can still run before it's turn is over.
+	int64_t deficit;
+} _tina_queue_set_member;
+
+struct tina_queue_set {
+	_tina_queue_set_member* members;
+	unsigned count;
+	// Index of the member whose turn it is.
+	unsigned cursor;
+	
+	// Semaphore to wait for more work in any of the set's queues.
+	_TINA_COND_T semaphore_signal;
+	unsigned semaphore_count;
+	// Incremented each time the set is interrupted.
+	unsigned interrupt_stamp;
+};
+
+struct _tina_subscription_link {
+	_tina_queue* queue;
+	tina_subscription* sub;
+	// Next link in the queue's list of subscribers.
+	_tina_subscription_link* next;
+};
+
+struct tina_subscription {
+	// Links for each queue in order of preference.
+	_tina_subscription_link* links;
+	unsigned count;
+	
+	// Semaphore to wait for more work in any of the subscribed queues.
+	_TINA_COND_T semaphore_signal;
+	unsigned semaphore_count;
+	// Incremented each time the subscription is interrupted.
+	unsigned interrupt_stamp;
+};
+
 static void _tina_queue_signal(_tina_queue* queue){
 	if(queue->semaphore_count){
 		_TINA_COND_SIGNAL(queue->semaphore_signal);
 		queue->semaphore_count--;
-	} else if(queue->parent){
-		_tina_queue_signal(queue->parent);
+		return;
+	} else if(queue->set && queue->set->semaphore_count){
+		_TINA_COND_SIGNAL(queue->set->semaphore_signal);
+		queue->set->semaphore_count--;
+		return;
+	}
+	
+	// Wake up a worker from any subscription that includes the queue.
+	for(_tina_subscription_link* link = queue->subscribers; link; link = link->next){
+		tina_subscription* sub = link->sub;
+		if(sub->semaphore_count){
+			_TINA_COND_SIGNAL(sub->semaphore_signal);
+			sub->semaphore_count--;
+			return;
+		}
 	}
+	
+	if(queue->parent) _tina_queue_signal(queue->parent);
 }
 
-static tina_job* _tina_group_process_wait_list(tina_scheduler* sched, tina_group* group, tina_job* job){
-	if(job){
-		tina_job* next = _tina_group_process_wait_list(sched, group, job->wait_next);
-		if(group->_count <= job->wait_threshold){
-			// Push the waiting job to the back of it's queue.
-			_tina_queue* queue = &sched->_queues[job->desc.queue_idx];
-			queue->arr[queue->head++ & queue->mask] = job;
-			_tina_queue_signal(queue);
-			
-			// Unlink from wait list.
-			job->wait_next = NULL;
-			return next;
+// Push a job to the back of a queue and wake up a worker to run it.
+static inline void _tina_queue_push(_tina_queue* queue, tina_job* job){
+	if(queue->mode == TINA_QUEUE_FIFO){
+		queue->arr[queue->head++ & queue->mask] = job;
+	} else {
+		if(queue->mode == TINA_QUEUE_DEADLINE){
+			job->queue_key = job->desc.deadline ? job->desc.deadline : UINT64_MAX;
 		} else {
-			job->wait_next = next;
+			// The key is when the job would run in a FIFO queue, pushed back by it's priority. (saturating)
+			uint64_t now = _TINA_TIME_NS(), penalty = (uint64_t)job->desc.priority*queue->aging;
+			if(job->desc.priority && penalty/job->desc.priority != queue->aging) penalty = UINT64_MAX;
+			job->queue_key = (penalty > UINT64_MAX - now ? UINT64_MAX : now + penalty);
 		}
+		job->queue_seq = queue->heap_seq++;
+		_tina_heap_push(queue, job);
 	}
-	
-	return job;
+	_tina_queue_signal(queue);
 }
 
-static inline unsigned _tina_group_increment(tina_group* group, unsigned count, unsigned max_count){
-	if(max_count > 0){
-		// Handle already full.
-		if(group->_count >= max_count) return 0;
-		// Adjust count.
-		unsigned remaining = max_count - group->_count;
-		if(count > remaining) count = remaining;
+// State for a thread in tina_scheduler_run(). Lives on it's stack.
+struct _tina_worker {
+	_tina_queue* queue;
+	// Most recently enqueued job, which this worker will run next.
+	tina_job* runnext;
+	// Number of jobs in a row taken from 'runnext'.
+	unsigned runnext_streak;
+	// Woken job handed off to run immediately.
+	tina_job* handoff;
+	// Woken jobs that last ran on this worker, linked by 'wait_next'.
+	tina_job* local_head;
+	tina_job* local_tail;
+	bool sleeping;
+	// Next worker running the same queue.
+	_tina_worker* next;
+};
+
+// Worker for the current thread, if any. Lets enqueues from inside a job find the worker running it.
+// Every run function sets it, or clears it if it doesn't use a worker, and restores the outer one when it returns.
+static _TINA_THREAD_LOCAL _tina_worker* _tina_current_worker;
+
+// Fibers can resume on a different thread, but compilers may reuse the address of a thread local across a call to tina_yield().
+// Reading it in a function that can't be inlined makes sure it's looked up again on the current thread.
+static _TINA_NOINLINE _tina_worker* _tina_get_current_worker(void){return _tina_current_worker;}
+
+// Push a newly enqueued job, keeping it on the current worker if the queue allows it.
+static inline void _tina_queue_spawn(_tina_queue* queue, tina_job* job){
+	_tina_worker* worker = _tina_get_current_worker();
+	if(queue->runnext_limit && worker && worker->queue == queue && queue->mode == TINA_QUEUE_FIFO){
+		tina_job* old = worker->runnext;
+		worker->runnext = job;
+		if(old){
+			// Kick the previous job out to the shared queue. Pushing it wakes an idle worker.
+			_tina_queue_push(queue, old);
+		} else {
+			queue->runnext_count++;
+			// Wake an idle worker anyway. It will steal the job if this worker doesn't get to it first.
+			_tina_queue_signal(queue);
+		}
+	} else {
+		_tina_queue_push(queue, job);
 	}
-	
-	group->_count += count;
-	return count;
 }
 
-static inline void _tina_group_decrement(tina_scheduler* sched, tina_group* group, unsigned count){
-	group->_count -= count;
-	group->_job_list = _tina_group_process_wait_list(sched, group, group->_job_list);
+static tina_job* _tina_worker_pop_local(_tina_worker* worker){
+	tina_job* job = worker->local_head;
+	if(job){
+		worker->local_head = job->wait_next;
+		if(!worker->local_head) worker->local_tail = NULL;
+		job->wait_next = NULL;
+	}
+	return job;
 }
 
-static inline void _tina_scheduler_execute_job(tina_scheduler* sched, tina_job* job){
-	_TINA_ASSERT(sched->_fibers.count > 0, "Tina Jobs Error: Ran out of fibers.");
-	// Assign a fiber and the thread data. (Jobs that are resuming already have a fiber)
-	if(job->fiber == NULL) job->fiber = (tina*)sched->_fibers.arr[--sched->_fibers.count];
-	
-	// Unlock the scheduler while executing the job. Fibers re-lock it before yielding back.
-	_TINA_MUTEX_UNLOCK(sched->_lock);
-	
-	_TINA_PROFILE_ENTER(job);
-	_tina_job_status status = (_tina_job_status)(uintptr_t)tina_resume(job->fiber, job);
-	_TINA_PROFILE_LEAVE(job, status);
+// Push a job that finished waiting, preferably back to the worker it last ran on.
+static void _tina_queue_wake(_tina_queue* queue, tina_job* job){
+	_tina_worker* current = _tina_get_current_worker();
+	if(queue->handoff && current && current->queue == queue && !current->handoff){
+		// Run it next on this worker without going through the queue.
+		current->handoff = job;
+		return;
+	}
 	
-	switch(status){
+	if(queue->affinity != TINA_AFFINITY_NONE && queue->mode == TINA_QUEUE_FIFO && job->last_worker){
+		for(_tina_worker* worker = queue->workers; worker; worker = worker->next){
+			if(worker != job->last_worker) continue;
+			
+			job->wait_next = NULL;
+			if(worker->local_tail){
+				worker->local_tail->wait_next = job;
+			} else {
+				worker->local_head = job;
+			}
+			worker->local_tail = job;
+			
+			if(worker->sleeping){
+				// There's no way to signal a specific worker, so wake them all. The others will go back to sleep.
+				_TINA_COND_BROADCAST(queue->semaphore_signal);
+				queue->semaphore_count = 0;
+			} else if(queue->affinity == TINA_AFFINITY_PREFER){
+				// The worker is busy. Let an idle worker steal the job.
+				_tina_queue_signal(queue);
+			}
+			return;
+		}
+	}
+	
+	_tina_queue_push(queue, job);
+}
+
+static tina_job* _tina_worker_next_job(_tina_worker* worker){
+	_tina_queue* queue = worker->queue;
+	tina_job* job = worker->handoff;
+	if(job){
+		worker->handoff = NULL;
+		return job;
+	}
+	
+	job = worker->runnext;
+	if(job && worker->runnext_streak < queue->runnext_limit){
+		worker->runnext = NULL;
+		worker->runnext_streak++;
+		queue->runnext_count--;
+		return job;
+	}
+	
+	// Resume woken jobs that last ran here, then take a job from the shared queue, then fall back to 'runnext'.
+	worker->runnext_streak = 0;
+	tina_job* next = worker->local_head ? _tina_worker_pop_local(worker) : _tina_queue_next_job(queue);
+	if(next) return next;
+	if(job){
+		worker->runnext = NULL;
+		queue->runnext_count--;
+		return job;
+	}
+	
+	// Steal from another worker's slot, or it's woken jobs if the queue allows it.
+	for(_tina_worker* other = queue->workers; other; other = other->next){
+		if(other->runnext){
+			job = other->runnext;
+			other->runnext = NULL;
+			queue->runnext_count--;
+			return job;
+		} else if(other->local_head && queue->affinity == TINA_AFFINITY_PREFER){
+			return _tina_worker_pop_local(other);
+		}
+	}
+	return NULL;
+}
+
+static tina_job* _tina_group_process_wait_list(tina_scheduler* sched, tina_group* group, tina_job* job){
+	if(job){
+		tina_job* next = _tina_group_process_wait_list(sched, group, job->wait_next);
+		if(group->_count <= job->wait_threshold){
+			// Push the waiting job to the back of it's queue.
+			_tina_queue_wake(&sched->_queues[job->desc.queue_idx], job);
+			
+			// Unlink from wait list.
+			job->wait_next = NULL;
+			return next;
+		} else {
+			job->wait_next = next;
+		}
+	}
+	
+	return job;
+}
+
+static inline unsigned _tina_group_increment(tina_group* group, unsigned count, unsigned max_count){
+	if(max_count > 0){
+		// Handle already full.
+		if(group->_count >= max_count) return 0;
+		// Adjust count.
+		unsigned remaining = max_count - group->_count;
+		if(count > remaining) count = remaining;
+	}
+	
+	group->_count += count;
+	return count;
+}
+
+static inline void _tina_group_decrement(tina_scheduler* sched, tina_group* group, unsigned count){
+	group->_count -= count;
+	group->_job_list = _tina_group_process_wait_list(sched, group, group->_job_list);
+}
+
+// Link a job into the wheel based on how far away it's deadline is.
+static void _tina_timer_link(tina_scheduler* sched, tina_job* job){
+	// Round up so jobs never wake early.
+	uint64_t tick = (job->timer_deadline + ((uint64_t)1 << _TINA_TIMER_RESOLUTION) - 1) >> _TINA_TIMER_RESOLUTION;
+	if(tick <= sched->_timer_tick){
+		sched->_timer_count--;
+		_tina_queue_push(&sched->_queues[job->desc.queue_idx], job);
+		return;
+	}
+	
+	uint64_t delta = tick - sched->_timer_tick;
+	unsigned level = 0;
+	while(level < _TINA_TIMER_LEVELS - 1 && delta >> (_TINA_TIMER_BITS*(level + 1))) level++;
+	
+	// Deadlines past the end of the top level are parked in it's furthest slot and re-linked when it cascades.
+	uint64_t max_delta = ((uint64_t)1 << (_TINA_TIMER_BITS*_TINA_TIMER_LEVELS)) - 1;
+	if(delta > max_delta) tick = sched->_timer_tick + max_delta;
+	
+	unsigned slot = (tick >> (_TINA_TIMER_BITS*level)) & _TINA_TIMER_MASK;
+	job->wait_next = sched->_timer_wheel[level][slot];
+	sched->_timer_wheel[level][slot] = job;
+	sched->_timer_occupied[level] |= (uint64_t)1 << slot;
+}
+
+// Earliest time the wheel might have something to expire. Only exact for the bottom level, higher levels wake at the next cascade.
+static uint64_t _tina_timer_next_deadline(tina_scheduler* sched){
+	uint64_t tick = sched->_timer_tick;
+	unsigned slot = tick & _TINA_TIMER_MASK;
+	uint64_t ahead = slot < _TINA_TIMER_MASK ? sched->_timer_occupied[0] >> (slot + 1) : 0;
+	uint64_t next = ahead ? tick + 1 + _TINA_CTZ64(ahead) : (tick | _TINA_TIMER_MASK) + 1;
+	return next << _TINA_TIMER_RESOLUTION;
+}
+
+static void _tina_timer_add(tina_scheduler* sched, tina_job* job, uint64_t now){
+	// Nothing is in the wheel, so it's safe to fast forward it.
+	if(sched->_timer_count == 0) sched->_timer_tick = now >> _TINA_TIMER_RESOLUTION;
+	sched->_timer_count++;
+	_tina_timer_link(sched, job);
+	
+	if(sched->_timer_keeper && _tina_timer_next_deadline(sched) < sched->_timer_keeper_deadline){
+		// Wake the timer keeper so it can wait for the new deadline instead.
+		_TINA_COND_BROADCAST(*sched->_timer_keeper);
+		*sched->_timer_keeper_count = 0;
+		sched->_timer_keeper_deadline = 0;
+	} else if(!sched->_timer_keeper && sched->_timer_count){
+		// Wake up an idle worker to become the timer keeper.
+		_tina_queue_signal(&sched->_queues[job->desc.queue_idx]);
+	}
+}
+
+// Advance the wheel to the current time and push any jobs that are due onto their queues.
+static void _tina_timer_update(tina_scheduler* sched){
+	uint64_t now = _TINA_TIME_NS() >> _TINA_TIMER_RESOLUTION;
+	while(sched->_timer_count && sched->_timer_tick < now){
+		// Skip ahead to the next non-empty bottom slot, or the next cascade, whichever comes first.
+		uint64_t next = _tina_timer_next_deadline(sched) >> _TINA_TIMER_RESOLUTION;
+		uint64_t tick = sched->_timer_tick = (next < now ? next : now);
+		
+		// Find the highest level that wrapped around, then cascade it's current slot down starting from the top.
+		unsigned levels = 1;
+		while(levels < _TINA_TIMER_LEVELS && (tick & (((uint64_t)1 << (_TINA_TIMER_BITS*levels)) - 1)) == 0) levels++;
+		for(unsigned level = levels - 1; level > 0; level--){
+			unsigned slot = (tick >> (_TINA_TIMER_BITS*level)) & _TINA_TIMER_MASK;
+			tina_job* job = sched->_timer_wheel[level][slot];
+			sched->_timer_wheel[level][slot] = NULL;
+			sched->_timer_occupied[level] &= ~((uint64_t)1 << slot);
+			
+			while(job){
+				tina_job* next_job = job->wait_next;
+				_tina_timer_link(sched, job);
+				job = next_job;
+			}
+		}
+		
+		// Everything in the current bottom slot is due now.
+		unsigned slot = tick & _TINA_TIMER_MASK;
+		tina_job* job = sched->_timer_wheel[0][slot];
+		sched->_timer_wheel[0][slot] = NULL;
+		sched->_timer_occupied[0] &= ~((uint64_t)1 << slot);
+		while(job){
+			tina_job* next_job = job->wait_next;
+			job->wait_next = NULL;
+			sched->_timer_count--;
+			_tina_queue_push(&sched->_queues[job->desc.queue_idx], job);
+			job = next_job;
+		}
+	}
+}
+
+// Copy a pointer array into a bigger one on the heap.
+static void** _tina_grow_array(void** arr, size_t count, size_t capacity, bool owned){
+	void** copy = (void**)_TINA_JOBS_ALLOC(capacity*sizeof(void*));
+	if(copy){
+		memcpy(copy, arr, count*sizeof(void*));
+		if(owned) _TINA_JOBS_FREE(arr);
+	}
+	return copy;
+}
+
+// Make sure there are at least 'needed' jobs in the pool if the limit allows it.
+static void _tina_scheduler_grow_jobs(tina_scheduler* sched, size_t needed){
+	while(sched->_job_pool.count < needed && sched->_job_count < sched->_max_jobs){
+		unsigned count = sched->_max_jobs - sched->_job_count;
+		if(count > sched->_initial_job_count) count = sched->_initial_job_count;
+		unsigned total = sched->_job_count + count;
+		
+		if(total > sched->_job_capacity){
+			// Queues must be able to hold every job, and their size must be a power of two.
+			size_t capacity = sched->_job_capacity;
+			while(capacity < total) capacity *= 2;
+			
+			void** pool = _tina_grow_array(sched->_job_pool.arr, sched->_job_pool.count, capacity, sched->_jobs_grown);
+			if(!pool) return;
+			sched->_job_pool.arr = pool;
+			
+			for(unsigned i = 0; i < sched->_queue_count; i++){
+				_tina_queue* queue = &sched->_queues[i];
+				void** arr = (void**)_TINA_JOBS_ALLOC(capacity*sizeof(void*));
+				_TINA_ASSERT(arr, "Tina Jobs Error: Failed to grow a queue.");
+				
+				// Unwrap the ring, or copy the heap as is.
+				size_t n = queue->head - queue->tail;
+				for(size_t j = 0; j < n; j++) arr[j] = queue->arr[(queue->tail + j) & queue->mask];
+				memcpy(arr + n, queue->arr, queue->heap_count*sizeof(void*));
+				if(sched->_jobs_grown) _TINA_JOBS_FREE(queue->arr);
+				queue->arr = arr;
+				queue->tail = 0, queue->head = n;
+				queue->mask = capacity - 1;
+			}
+			sched->_job_capacity = capacity;
+			sched->_jobs_grown = true;
+		}
+		
+		size_t stride = _tina_jobs_align(sizeof(tina_job));
+		// The chunk header takes up the first job slot.
+		uint8_t* buffer = (uint8_t*)_TINA_JOBS_ALLOC(stride + count*stride);
+		if(!buffer) return;
+		_tina_job_chunk* chunk = (_tina_job_chunk*)buffer;
+		chunk->next = sched->_job_chunks;
+		chunk->count = count;
+		sched->_job_chunks = chunk;
+		for(unsigned i = 0; i < count; i++) sched->_job_pool.arr[sched->_job_pool.count++] = buffer + stride*(i + 1);
+		
+		sched->_job_count = total;
+		sched->_last_growth = _TINA_TIME_NS();
+	}
+}
+
+// Add another chunk of fibers to the pool if the limit allows it.
+static void _tina_scheduler_grow_fibers(tina_scheduler* sched, _tina_fiber_pool* pool){
+	if(pool->count >= pool->max_count) return;
+	unsigned count = pool->max_count - pool->count;
+	if(count > pool->initial_count) count = pool->initial_count;
+	unsigned total = pool->count + count;
+	
+	if(total > pool->capacity){
+		size_t capacity = 2*pool->capacity;
+		if(capacity < total) capacity = total;
+		void** arr = _tina_grow_array(pool->fibers.arr, pool->fibers.count, capacity, pool->grown);
+		if(!arr) return;
+		pool->fibers.arr = arr;
+		pool->capacity = capacity;
+		pool->grown = true;
+	}
+	
+	// Put the chunk header and info first, then the stacks.
+	size_t header_size = _tina_jobs_align(sizeof(_tina_fiber_chunk)) + _tina_jobs_align(count*sizeof(_tina_fiber_info));
+	uint8_t* buffer = (uint8_t*)_TINA_JOBS_ALLOC(header_size + count*pool->stack_size);
+	if(!buffer) return;
+	_tina_fiber_chunk* chunk = (_tina_fiber_chunk*)buffer;
+	chunk->base = buffer + header_size;
+	chunk->count = count;
+	chunk->info = (_tina_fiber_info*)(buffer + _tina_jobs_align(sizeof(_tina_fiber_chunk)));
+	chunk->next = pool->chunks.next;
+	pool->chunks.next = chunk;
+	
+	for(unsigned i = 0; i < count; i++){
+		uint8_t* stack = chunk->base + i*pool->stack_size;
+		pool->fibers.arr[pool->fibers.count++] = sched->_fiber_factory(sched, pool->count + i, stack, pool->stack_size, sched->_factory_data);
+		_tina_fiber_info info = {.owner = NULL, .busy = false, .deferred = NULL, .trimmed = false, .hibernated = 0};
+		chunk->info[i] = info;
+	}
+	
+	pool->count = total;
+	sched->_last_growth = _TINA_TIME_NS();
+}
+
+// Remove the items between 'begin' and 'end' from a stack, but only if all 'count' of them are in it.
+static bool _tina_stack_take_range(_tina_stack* stack, void* begin, void* end, size_t count){
+	size_t found = 0;
+	for(size_t i = 0; i < stack->count; i++){
+		uint8_t* item = (uint8_t*)stack->arr[i];
+		if((uint8_t*)begin <= item && item < (uint8_t*)end) found++;
+	}
+	if(found < count) return false;
+	
+	size_t kept = 0;
+	for(size_t i = 0; i < stack->count; i++){
+		uint8_t* item = (uint8_t*)stack->arr[i];
+		if(item < (uint8_t*)begin || (uint8_t*)end <= item) stack->arr[kept++] = item;
+	}
+	stack->count = kept;
+	return true;
+}
+
+// Free the grown chunks that have all of their jobs or fibers back in the pools.
+// Returns when to try again if the pools grew too recently, or 0.
+static uint64_t _tina_scheduler_shrink(tina_scheduler* sched){
+	// Only stack class 0 grows.
+	_tina_fiber_pool* pool = &sched->_stack_classes[0];
+	if(!sched->_job_chunks && !pool->chunks.next) return 0;
+	uint64_t deadline = sched->_last_growth + sched->_shrink_delay;
+	if(_TINA_TIME_NS() < deadline) return deadline;
+	
+	size_t stride = _tina_jobs_align(sizeof(tina_job));
+	_tina_job_chunk** job_link = &sched->_job_chunks;
+	while(*job_link){
+		_tina_job_chunk* chunk = *job_link;
+		uint8_t* begin = (uint8_t*)chunk + stride;
+		if(_tina_stack_take_range(&sched->_job_pool, begin, begin + chunk->count*stride, chunk->count)){
+			*job_link = chunk->next;
+			sched->_job_count -= chunk->count;
+			_TINA_JOBS_FREE(chunk);
+		} else {
+			job_link = &chunk->next;
+		}
+	}
+	
+	// Same for the fibers, but hibernated jobs need their fiber to wake up on.
+	_tina_fiber_chunk** fiber_link = &pool->chunks.next;
+	while(*fiber_link){
+		_tina_fiber_chunk* chunk = *fiber_link;
+		bool hibernated = false;
+		for(unsigned i = 0; i < chunk->count; i++) hibernated |= chunk->info[i].hibernated > 0;
+		if(!hibernated && _tina_stack_take_range(&pool->fibers, chunk->base, chunk->base + chunk->count*pool->stack_size, chunk->count)){
+			*fiber_link = chunk->next;
+			pool->count -= chunk->count;
+			_TINA_JOBS_FREE(chunk);
+		} else {
+			fiber_link = &chunk->next;
+		}
+	}
+	return 0;
+}
+
+// Record stats and return a finished job to the pool. The caller is responsible for it's fiber.
+static void _tina_job_finish(tina_scheduler* sched, tina_job* job, uint64_t now){
+	uint64_t deadline = job->desc.deadline;
+	if(deadline){
+		tina_queue_stats* stats = &sched->_queues[job->desc.queue_idx].stats;
+		stats->completed++;
+		if(now > deadline){
+			stats->missed++;
+			if(now - deadline > stats->max_lateness) stats->max_lateness = now - deadline;
+		}
+	}
+	
+	sched->_job_pool.arr[sched->_job_pool.count++] = job;
+	
+	// Wake up a job that's waiting to enqueue more.
+	tina_job* waiter = sched->_capacity_waiters;
+	if(waiter){
+		sched->_capacity_waiters = waiter->wait_next;
+		waiter->wait_next = NULL;
+		_tina_queue_push(&sched->_queues[waiter->desc.queue_idx], waiter);
+	}
+	
+	// Did it have a group, and was it the last job being waited for?
+	tina_group* group = job->group;
+	if(group) _tina_group_decrement(sched, group, 1);
+	
+	// Workers retry when they go idle, so only check when everything is back in the pools.
+	_tina_fiber_pool* pool = &sched->_stack_classes[0];
+	bool grown = sched->_job_count > sched->_initial_job_count || pool->count > pool->initial_count;
+	if(grown && sched->_job_pool.count == sched->_job_count && pool->fibers.count == pool->count) _tina_scheduler_shrink(sched);
+}
+
+// Get the pool a job's fiber came from.
+static inline _tina_fiber_pool* _tina_job_fiber_pool(tina_scheduler* sched, tina_job* job){
+	return &sched->_stack_classes[job->stack_class];
+}
+
+static inline _tina_fiber_info* _tina_get_fiber_info(_tina_fiber_pool* pool, tina* fiber){
+	_tina_fiber_chunk* chunk = &pool->chunks;
+	size_t offset = (uint8_t*)fiber - chunk->base;
+	while(offset >= chunk->count*pool->stack_size){
+		chunk = chunk->next;
+		offset = (uint8_t*)fiber - chunk->base;
+	}
+	return &chunk->info[offset/pool->stack_size];
+}
+
+static inline uint8_t* _tina_fiber_stack_top(tina* fiber){
+	return (uint8_t*)fiber->_canary_end + sizeof(*fiber->_canary_end);
+}
+
+static void _tina_idle_unlink(tina_scheduler* sched, tina_job* job){
+	if(!job->idle) return;
+	if(job->idle_prev) job->idle_prev->idle_next = job->idle_next; else sched->_idle_head = job->idle_next;
+	if(job->idle_next) job->idle_next->idle_prev = job->idle_prev; else sched->_idle_tail = job->idle_prev;
+	job->idle_prev = job->idle_next = NULL;
+	job->idle = false;
+}
+
+// Pick the stack class for a job that hasn't started yet.
+static inline unsigned _tina_job_stack_class(tina_scheduler* sched, tina_job* job){
+	return job->desc.stack_class ? job->desc.stack_class : sched->_queues[job->desc.queue_idx].stack_class;
+}
+
+// Pop a fiber for a job that's starting. If the pool is empty, defer the job until a fiber is returned.
+static bool _tina_scheduler_take_fiber(tina_scheduler* sched, tina_job* job){
+	job->stack_class = _tina_job_stack_class(sched, job);
+	_tina_fiber_pool* pool = _tina_job_fiber_pool(sched, job);
+	if(pool->fibers.count == 0) _tina_scheduler_grow_fibers(sched, pool);
+	if(pool->fibers.count == 0){
+		job->wait_next = NULL;
+		if(pool->wait_tail) pool->wait_tail->wait_next = job; else pool->wait_head = job;
+		pool->wait_tail = job;
+		return false;
+	}
+	
+	job->fiber = (tina*)pool->fibers.arr[--pool->fibers.count];
+	return true;
+}
+
+// Retry a job that was deferred waiting for a fiber from the pool.
+static void _tina_fiber_pool_retry(tina_scheduler* sched, _tina_fiber_pool* pool){
+	tina_job* job = pool->wait_head;
+	if(job){
+		pool->wait_head = job->wait_next;
+		if(!pool->wait_head) pool->wait_tail = NULL;
+		job->wait_next = NULL;
+		_tina_queue_push(&sched->_queues[job->desc.queue_idx], job);
+	}
+}
+
+// Return a fiber to the pool, and retry a job that was deferred waiting for one.
+static void _tina_scheduler_give_fiber(tina_scheduler* sched, _tina_fiber_pool* pool, tina* fiber){
+	pool->fibers.arr[pool->fibers.count++] = fiber;
+	if(sched->_trim) _tina_get_fiber_info(pool, fiber)->trimmed = false;
+	_tina_fiber_pool_retry(sched, pool);
+}
+
+// How many fibers tina_scheduler_trim_stacks() takes out of a pool at a time.
+#ifndef _TINA_TRIM_BATCH
+#define _TINA_TRIM_BATCH 32
+#endif
+
+// Find the pages of an idle fiber's stack that can be released. Returns false if there aren't any.
+static bool _tina_fiber_trim_range(tina_scheduler* sched, tina* fiber, uintptr_t* begin, uintptr_t* end){
+	// Everything below the idle fiber's frame is garbage. Keep the header page and some stack below the frame.
+	uintptr_t page_mask = (uintptr_t)_TINA_PAGE_SIZE() - 1;
+	uintptr_t sp = (uintptr_t)fiber->_stack_pointer;
+	*begin = ((uintptr_t)(fiber + 1) + page_mask) & ~page_mask;
+	if(sp < *begin + sched->_trim_keep_bytes + page_mask + 1) return false;
+	*end = (sp - sched->_trim_keep_bytes) & ~page_mask;
+	return true;
+}
+
+size_t tina_scheduler_trim_stacks(tina_scheduler* sched){
+	size_t released = 0;
+	for(unsigned i = 0; i < _TINA_MAX_STACK_CLASSES; i++){
+		_tina_fiber_pool* pool = &sched->_stack_classes[i];
+		while(true){
+			tina* batch[_TINA_TRIM_BATCH];
+			bool trimmed[_TINA_TRIM_BATCH];
+			unsigned count = 0, progress = 0;
+			uintptr_t begin, end;
+			
+			// Take untrimmed fibers out of the bottom of the pool where the coldest ones are, so nothing runs on them meanwhile.
+			_TINA_MUTEX_LOCK(sched->_lock);
+			if(sched->_trim && i < sched->_stack_class_count){
+				size_t cold = pool->fibers.count > sched->_trim_keep_fibers ? pool->fibers.count - sched->_trim_keep_fibers : 0;
+				size_t kept = 0;
+				for(size_t j = 0; j < pool->fibers.count; j++){
+					tina* fiber = (tina*)pool->fibers.arr[j];
+					bool take = j < cold && count < _TINA_TRIM_BATCH;
+					take = take && !_tina_get_fiber_info(pool, fiber)->trimmed && _tina_fiber_trim_range(sched, fiber, &begin, &end);
+					if(take) batch[count++] = fiber; else pool->fibers.arr[kept++] = fiber;
+				}
+				pool->fibers.count = kept;
+			}
+			_TINA_MUTEX_UNLOCK(sched->_lock);
+			if(count == 0) break;
+			
+			// Release the pages without holding the lock.
+			for(unsigned j = 0; j < count; j++){
+				_tina_fiber_trim_range(sched, batch[j], &begin, &end);
+				size_t resident = _TINA_PAGES_RESIDENT((void*)begin, end - begin);
+				trimmed[j] = _TINA_PAGES_RELEASE((void*)begin, end - begin);
+				if(trimmed[j]) released += resident, progress++;
+			}
+			
+			// Put them back at the bottom of the pool, and retry jobs that were deferred waiting for a fiber meanwhile.
+			_TINA_MUTEX_LOCK(sched->_lock);
+			memmove(pool->fibers.arr + count, pool->fibers.arr, pool->fibers.count*sizeof(void*));
+			for(unsigned j = 0; j < count; j++){
+				pool->fibers.arr[j] = batch[j];
+				_tina_get_fiber_info(pool, batch[j])->trimmed = trimmed[j];
+			}
+			pool->fibers.count += count;
+			for(unsigned j = 0; j < count; j++) _tina_fiber_pool_retry(sched, pool);
+			_TINA_MUTEX_UNLOCK(sched->_lock);
+			
+			if(count < _TINA_TRIM_BATCH || progress == 0) break;
+		}
+	}
+	return released;
+}
+
+size_t tina_scheduler_stack_resident(tina_scheduler* sched){
+	size_t page_size = _TINA_PAGE_SIZE(), resident = 0;
+	_TINA_MUTEX_LOCK(sched->_lock);
+	for(unsigned i = 0; i < sched->_stack_class_count; i++){
+		_tina_fiber_pool* pool = &sched->_stack_classes[i];
+		for(_tina_fiber_chunk* chunk = &pool->chunks; chunk; chunk = chunk->next){
+			// Stacks don't start on a page boundary, so include the partial page before them.
+			uintptr_t begin = (uintptr_t)chunk->base & ~(uintptr_t)(page_size - 1);
+			uintptr_t end = (uintptr_t)chunk->base + chunk->count*pool->stack_size;
+			resident += _TINA_PAGES_RESIDENT((void*)begin, end - begin);
+		}
+	}
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+	return resident;
+}
+
+// Copy a suspended job's stack aside, and give it's fiber back to the pool.
+static void _tina_job_hibernate(tina_scheduler* sched, tina_job* job){
+	tina* fiber = job->fiber;
+	uint8_t* top = _tina_fiber_stack_top(fiber);
+	uint8_t* sp = (uint8_t*)fiber->_stack_pointer;
+	uintptr_t group = (uintptr_t)job->wait_group;
+	_TINA_ASSERT(group < (uintptr_t)fiber || group >= (uintptr_t)top, "Tina Jobs Error: Can't hibernate a job waiting on a group stored on it's stack.");
+	
+	uint8_t* image = (uint8_t*)_TINA_JOBS_ALLOC(sizeof(tina) + (top - sp));
+	_TINA_ASSERT(image, "Tina Jobs Error: Failed to allocate a hibernated stack.");
+	memcpy(image, fiber, sizeof(tina));
+	memcpy(image + sizeof(tina), sp, top - sp);
+	job->hibernated = image;
+	_tina_idle_unlink(sched, job);
+	
+	// Reset the fiber so it starts fresh for the next job.
+	size_t size = fiber->size + ((uint8_t*)fiber - (uint8_t*)fiber->buffer);
+	tina_init(fiber->buffer, size, fiber->body, fiber->user_data);
+	_tina_fiber_pool* pool = _tina_job_fiber_pool(sched, job);
+	_tina_fiber_info* info = _tina_get_fiber_info(pool, fiber);
+	info->owner = NULL;
+	info->hibernated++;
+	_tina_scheduler_give_fiber(sched, pool, fiber);
+}
+
+// Copy a hibernated job's stack back onto it's fiber. Returns false if the fiber is busy, and defers the job until it's not.
+static bool _tina_job_restore(tina_scheduler* sched, tina_job* job){
+	tina* fiber = job->fiber;
+	_tina_fiber_pool* pool = _tina_job_fiber_pool(sched, job);
+	_tina_fiber_info* info = _tina_get_fiber_info(pool, fiber);
+	if(info->owner && info->busy){
+		job->wait_next = info->deferred;
+		info->deferred = job;
+		return false;
+	} else if(info->owner){
+		_tina_job_hibernate(sched, info->owner);
+	}
+	
+	// Take the fiber back out of the pool.
+	size_t i = pool->fibers.count;
+	while(pool->fibers.arr[--i] != fiber){}
+	pool->fibers.arr[i] = pool->fibers.arr[--pool->fibers.count];
+	
+	uint8_t* image = (uint8_t*)job->hibernated;
+	uint8_t* sp = (uint8_t*)((tina*)image)->_stack_pointer;
+	memcpy(sp, image + sizeof(tina), _tina_fiber_stack_top(fiber) - sp);
+	memcpy(fiber, image, sizeof(tina));
+	_TINA_JOBS_FREE(image);
+	job->hibernated = NULL;
+	info->hibernated--;
+	return true;
+}
+
+// Find a fiber for a job when hibernation is enabled. Returns false if the job was deferred.
+static bool _tina_hibernate_acquire(tina_scheduler* sched, tina_job* job){
+	_tina_idle_unlink(sched, job);
+	if(sched->_hibernate_age && sched->_idle_head){
+		uint64_t now = _TINA_TIME_NS();
+		while(sched->_idle_head && now - sched->_idle_head->idle_since >= sched->_hibernate_age) _tina_job_hibernate(sched, sched->_idle_head);
+	}
+	
+	if(job->hibernated){
+		if(!_tina_job_restore(sched, job)) return false;
+	} else if(job->fiber == NULL){
+		// Running low on fibers, so hibernate the job that's been waiting the longest on a fiber from the same pool.
+		unsigned stack_class = _tina_job_stack_class(sched, job);
+		if(sched->_stack_classes[stack_class].fibers.count < sched->_hibernate_reserve){
+			tina_job* oldest = sched->_idle_head;
+			while(oldest && oldest->stack_class != stack_class) oldest = oldest->idle_next;
+			if(oldest) _tina_job_hibernate(sched, oldest);
+		}
+		if(!_tina_scheduler_take_fiber(sched, job)) return false;
+	}
+	
+	_tina_fiber_info* info = _tina_get_fiber_info(_tina_job_fiber_pool(sched, job), job->fiber);
+	info->owner = job;
+	info->busy = true;
+	return true;
+}
+
+// Update a fiber's owner after it suspends or completes, and retry any jobs deferred on it.
+static void _tina_hibernate_release(tina_scheduler* sched, _tina_fiber_pool* pool, tina* fiber, tina_job* owner, bool waiting){
+	_tina_fiber_info* info = _tina_get_fiber_info(pool, fiber);
+	info->owner = owner;
+	info->busy = false;
+	
+	if(waiting){
+		owner->idle_since = _TINA_TIME_NS();
+		owner->idle_prev = sched->_idle_tail;
+		owner->idle_next = NULL;
+		if(sched->_idle_tail) sched->_idle_tail->idle_next = owner; else sched->_idle_head = owner;
+		sched->_idle_tail = owner;
+		owner->idle = true;
+	}
+	
+	while(info->deferred){
+		tina_job* job = info->deferred;
+		info->deferred = job->wait_next;
+		job->wait_next = NULL;
+		_tina_queue_push(&sched->_queues[job->desc.queue_idx], job);
+	}
+}
+
+// Returns false if the job was deferred until a fiber is available instead of running.
+static inline bool _tina_scheduler_execute_job(tina_scheduler* sched, tina_job* job){
+	// Assign a fiber and the thread data. (Jobs that are resuming already have a fiber)
+	if(sched->_hibernate){
+		if(!_tina_hibernate_acquire(sched, job)) return false;
+	} else if(job->fiber == NULL){
+		if(!_tina_scheduler_take_fiber(sched, job)) return false;
+	}
+	job->last_worker = _tina_get_current_worker();
+	// Start a new time slice each time the job is resumed.
+	uint64_t slice = sched->_queues[job->desc.queue_idx].timeslice;
+	job->slice_start = sched->_slice_clock;
+	job->slice_length = (uintptr_t)((slice + ((uint64_t)1 << _TINA_SLICE_RESOLUTION) - 1) >> _TINA_SLICE_RESOLUTION);
+	
+	// Unlock the scheduler while executing the job. Fibers re-lock it before yielding back.
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+	
+	_TINA_PROFILE_ENTER(job);
+	uintptr_t result = (uintptr_t)tina_resume(job->fiber, job);
+	_tina_job_status status = (_tina_job_status)(result & _TINA_STATUS_MASK);
+	_TINA_PROFILE_LEAVE(job, status);
+	
+	// The job that suspended the fiber. Not the resumed one if a nested job suspended it.
+	job = (tina_job*)(result & ~(uintptr_t)_TINA_STATUS_MASK);
+	switch(status){
 		case _TINA_STATUS_COMPLETED: {
+			uint64_t now = job->desc.deadline ? _TINA_TIME_NS() : 0;
 			_TINA_MUTEX_LOCK(sched->_lock);
 			// Return the components to the pools.
-			sched->_job_pool.arr[sched->_job_pool.count++] = job;
-			sched->_fibers.arr[sched->_fibers.count++] = job->fiber;
-			
-			// Did it have a group, and was it the last job being waited for?
-			tina_group* group = job->group;
-			if(group) _tina_group_decrement(sched, group, 1);
+			_tina_fiber_pool* pool = _tina_job_fiber_pool(sched, job);
+			_tina_scheduler_give_fiber(sched, pool, job->fiber);
+			if(sched->_hibernate) _tina_hibernate_release(sched, pool, job->fiber, NULL, false);
+			_tina_job_finish(sched, job, now);
 		} break;
 		case _TINA_STATUS_YIELDING:{
 			_TINA_MUTEX_LOCK(sched->_lock);
+			if(sched->_hibernate) _tina_hibernate_release(sched, _tina_job_fiber_pool(sched, job), job->fiber, job, false);
 			// Push the job to the back of the queue.
-			_tina_queue* queue = &sched->_queues[job->desc.queue_idx];
-			queue->arr[queue->head++ & queue->mask] = job;
-			_tina_queue_signal(queue);
+			_tina_queue_push(&sched->_queues[job->desc.queue_idx], job);
 		} break;
 		case _TINA_STATUS_WAITING: {
-			// Do nothing. The job will be re-enqueued when it's done waiting.
-			// tina_job_wait() locks the scheduler before yielding.
+			// The fiber has completely switched out by now, so it's safe to publish it to the wait list.
+			// (This is the "on top" half of tina_job_wait(), so no lock is held across the switch)
+			_TINA_MUTEX_LOCK(sched->_lock);
+			if(sched->_hibernate) _tina_hibernate_release(sched, _tina_job_fiber_pool(sched, job), job->fiber, job, true);
+			tina_group* group = job->wait_group;
+			if(group->_count > job->wait_threshold){
+				// Push onto wait list. The job will be re-enqueued when it's done waiting.
+				job->wait_next = group->_job_list;
+				group->_job_list = job;
+			} else {
+				// The group finished while the job was switching out.
+				_tina_queue_push(&sched->_queues[job->desc.queue_idx], job);
+			}
 		} break;
+		case _TINA_STATUS_PARKED: {
+			// Hand off the job without the lock held. It may be unparked on another thread before this returns.
+			job->park_func(job, job->park_ctx);
+			_TINA_MUTEX_LOCK(sched->_lock);
+		} break;
+	}
+	return true;
+}
+
+static inline tina_job* _tina_scheduler_new_job(tina_scheduler* sched, const tina_job_description* desc, tina_group* group){
+	_TINA_ASSERT(desc->func, "Tina Jobs Error: Job must have a body function.");
+	_TINA_ASSERT(desc->stack_class < sched->_stack_class_count, "Tina Jobs Error: Invalid stack class.");
+	tina_job* job = (tina_job*)sched->_job_pool.arr[--sched->_job_pool.count];
+	tina_job job_value = {.desc = (*desc), .user_data = NULL, .fiber = NULL, .group = group, .wait_next = NULL, .wait_group = NULL, .wait_threshold = 0, .park_func = NULL, .park_ctx = NULL, .timer_deadline = 0, .queue_key = 0, .queue_seq = 0, .slice_start = 0, .slice_length = 0, .last_worker = NULL, .help_depth = 0, .stack_class = 0, .hibernated = NULL, .idle_prev = NULL, .idle_next = NULL, .idle_since = 0, .idle = false};
+	(*job) = job_value;
+	return job;
+}
+
+// Sleep on a semaphore until more work is added.
+static void _tina_scheduler_idle(tina_scheduler* sched, _TINA_COND_T* signal, unsigned* count){
+	// Free grown chunks that aren't in use anymore, or wake up again once the shrink delay passes.
+	uint64_t deadline = _tina_scheduler_shrink(sched);
+	
+	(*count)++;
+	bool keeper = sched->_timer_count && !sched->_timer_keeper;
+	if(keeper){
+		// Become the timer keeper, and also wake up for the next deadline.
+		uint64_t timer_deadline = _tina_timer_next_deadline(sched);
+		if(!deadline || timer_deadline < deadline) deadline = timer_deadline;
+		sched->_timer_keeper = signal;
+		sched->_timer_keeper_count = count;
+		sched->_timer_keeper_deadline = deadline;
+	}
+	
+	if(deadline){
+		bool timed_out = _TINA_COND_TIMEDWAIT(*signal, sched->_lock, deadline);
+		if(keeper){
+			sched->_timer_keeper = NULL;
+			sched->_timer_keeper_count = NULL;
+			sched->_timer_keeper_deadline = 0;
+		}
+		// Nobody signaled this thread, so take it back out of the count.
+		if(timed_out && *count) (*count)--;
+	} else {
+		_TINA_COND_WAIT(*signal, sched->_lock);
 	}
 }
 
@@ -396,26 +1932,67 @@ bool tina_scheduler_run(tina_scheduler* sched, unsigned queue_idx, tina_run_mode
 	_TINA_MUTEX_LOCK(sched->_lock); {
 		_tina_queue* queue = _tina_get_queue(sched, queue_idx);
 		
+		// Register this thread as a worker for the queue. (Jobs may run nested schedulers, so save the old one)
+		_tina_worker worker = {.queue = queue, .runnext = NULL, .runnext_streak = 0, .handoff = NULL, .local_head = NULL, .local_tail = NULL, .sleeping = false, .next = queue->workers};
+		queue->workers = &worker;
+		_tina_worker* prev_worker = _tina_current_worker;
+		_tina_current_worker = &worker;
+		
 		// Keep looping until the interrupt stamp is incremented.
 		unsigned stamp = queue->interrupt_stamp;
 		while(mode != TINA_RUN_LOOP || queue->interrupt_stamp == stamp){
-			tina_job* job = _tina_queue_next_job(queue);
+			if(sched->_timer_count) _tina_timer_update(sched);
+			tina_job* job = _tina_worker_next_job(&worker);
 			if(job){
-				_tina_scheduler_execute_job(sched, job);
+				if(!_tina_scheduler_execute_job(sched, job)) continue;
 				ran = true;
 				if(mode == TINA_RUN_SINGLE) break;
 			} else if(mode == TINA_RUN_LOOP){
 				// Sleep until more work is added to the queue.
-				queue->semaphore_count++;
-				_TINA_COND_WAIT(queue->semaphore_signal, sched->_lock);
+				worker.sleeping = true;
+				_tina_scheduler_idle(sched, &queue->semaphore_signal, &queue->semaphore_count);
+				worker.sleeping = false;
 			} else {
 				break;
 			}
 		}
+		
+		// Unregister, and give back any jobs left in the slots or the local queue.
+		_tina_current_worker = prev_worker;
+		_tina_worker** cursor = &queue->workers;
+		while(*cursor != &worker) cursor = &(*cursor)->next;
+		(*cursor) = worker.next;
+		if(worker.handoff) _tina_queue_push(queue, worker.handoff);
+		if(worker.runnext){
+			_tina_queue_push(queue, worker.runnext);
+			queue->runnext_count--;
+		}
+		while(worker.local_head) _tina_queue_push(queue, _tina_worker_pop_local(&worker));
 	} _TINA_MUTEX_UNLOCK(sched->_lock);
 	return ran;
 }
 
+unsigned tina_scheduler_run_budget(tina_scheduler* sched, unsigned queue_idx, uint64_t deadline, unsigned max_jobs){
+	unsigned count = 0;
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		_tina_queue* queue = _tina_get_queue(sched, queue_idx);
+		// Jobs in here don't have a worker, so hide the one from an outer run.
+		_tina_worker* prev_worker = _tina_current_worker;
+		_tina_current_worker = NULL;
+		
+		while(max_jobs == 0 || count < max_jobs){
+			if(deadline && _TINA_TIME_NS() >= deadline) break;
+			if(sched->_timer_count) _tina_timer_update(sched);
+			
+			tina_job* job = _tina_queue_next_job(queue);
+			if(!job) break;
+			if(_tina_scheduler_execute_job(sched, job)) count++;
+		}
+		_tina_current_worker = prev_worker;
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+	return count;
+}
+
 void tina_scheduler_interrupt(tina_scheduler* sched, unsigned queue_idx){
 	_TINA_MUTEX_LOCK(sched->_lock); {
 		_tina_queue* queue = _tina_get_queue(sched, queue_idx);
@@ -426,36 +2003,320 @@ void tina_scheduler_interrupt(tina_scheduler* sched, unsigned queue_idx){
 	} _TINA_MUTEX_UNLOCK(sched->_lock);
 }
 
-unsigned tina_scheduler_enqueue_batch(tina_scheduler* sched, const tina_job_description* list, unsigned count, tina_group* group, unsigned max_group_count){
+unsigned tina_scheduler_queue_workers(tina_scheduler* sched, unsigned queue_idx){
+	unsigned count = 0;
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		for(_tina_worker* worker = _tina_get_queue(sched, queue_idx)->workers; worker; worker = worker->next) count++;
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+	return count;
+}
+
+size_t tina_queue_set_size(unsigned count){
+	return _tina_jobs_align(sizeof(tina_queue_set)) + count*sizeof(_tina_queue_set_member);
+}
+
+tina_queue_set* tina_queue_set_init(void* buffer, tina_scheduler* sched, const unsigned* queue_idxs, const unsigned* weights, unsigned count){
+	_TINA_ASSERT(count > 0, "Tina Jobs Error: Queue set must not be empty.");
+	tina_queue_set* set = (tina_queue_set*)buffer;
+	set->members = (_tina_queue_set_member*)((uint8_t*)buffer + _tina_jobs_align(sizeof(tina_queue_set)));
+	set->count = count;
+	set->cursor = 0;
+	_TINA_COND_INIT(set->semaphore_signal);
+	set->semaphore_count = 0;
+	set->interrupt_stamp = 0;
+	
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		for(unsigned i = 0; i < count; i++){
+			_tina_queue* queue = _tina_get_queue(sched, queue_idxs[i]);
+			_TINA_ASSERT(!queue->set, "Tina Jobs Error: Queue already belongs to a set.");
+			_TINA_ASSERT(weights[i] > 0, "Tina Jobs Error: Queue weights must be non-zero.");
+			queue->set = set;
+			
+			_tina_queue_set_member member = {.queue = queue, .weight = weights[i], .deficit = (int64_t)weights[i]*_TINA_QUEUE_SET_QUANTUM};
+			set->members[i] = member;
+		}
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+	
+	return set;
+}
+
+void tina_queue_set_destroy(tina_scheduler* sched, tina_queue_set* set){
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		// Enqueuing checks the queue's set to know which workers to wake.
+		for(unsigned i = 0; i < set->count; i++) set->members[i].queue->set = NULL;
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+	_TINA_COND_DESTROY(set->semaphore_signal);
+}
+
+#ifndef TINA_NO_CRT
+tina_queue_set* tina_queue_set_new(tina_scheduler* sched, const unsigned* queue_idxs, const unsigned* weights, unsigned count){
+	void* buffer = malloc(tina_queue_set_size(count));
+	return tina_queue_set_init(buffer, sched, queue_idxs, weights, count);
+}
+
+void tina_queue_set_free(tina_scheduler* sched, tina_queue_set* set){
+	tina_queue_set_destroy(sched, set);
+	free(set);
+}
+#endif
+
+void tina_scheduler_set_weight(tina_scheduler* sched, tina_queue_set* set, unsigned queue_idx, unsigned weight){
+	_TINA_ASSERT(weight > 0, "Tina Jobs Error: Queue weights must be non-zero.");
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		_tina_queue* queue = _tina_get_queue(sched, queue_idx);
+		_TINA_ASSERT(queue->set == set, "Tina Jobs Error: Queue does not belong to the set.");
+		for(unsigned i = 0; i < set->count; i++){
+			if(set->members[i].queue == queue) set->members[i].weight = weight;
+		}
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+static bool _tina_queue_has_work(_tina_queue* queue){
+	for(; queue; queue = queue->fallback){
+		if(queue->head != queue->tail || queue->heap_count) return true;
+	}
+	return false;
+}
+
+// Pick the next job using deficit round robin, and return which member it belongs to.
+static tina_job* _tina_queue_set_next_job(tina_queue_set* set, _tina_queue_set_member** member_out){
+	while(true){
+		// Visit each member once starting with the one whose turn it is.
+		bool has_work = false;
+		for(unsigned visited = 0; visited < set->count; visited++){
+			_tina_queue_set_member* member = &set->members[set->cursor];
+			if(member->deficit > 0){
+				tina_job* job = _tina_queue_next_job(member->queue);
+				if(job){
+					(*member_out) = member;
+					return job;
+				}
+				// Idle queues don't bank any time.
+				member->deficit = 0;
+			} else {
+				has_work |= _tina_queue_has_work(member->queue);
+			}
+			
+			// End the turn, and give the next member it's quantum.
+			set->cursor = (set->cursor + 1) % set->count;
+			_tina_queue_set_member* next = &set->members[set->cursor];
+			next->deficit += (int64_t)next->weight*_TINA_QUEUE_SET_QUANTUM;
+		}
+		if(!has_work) return NULL;
+		
+		// Only members that overran their turns have work. Skip ahead the number of turns until one can run again.
+		uint64_t rounds = UINT64_MAX;
+		for(unsigned i = 0; i < set->count; i++){
+			_tina_queue_set_member* member = &set->members[i];
+			if(!_tina_queue_has_work(member->queue)) continue;
+			uint64_t quantum = (uint64_t)member->weight*_TINA_QUEUE_SET_QUANTUM;
+			uint64_t needed = (member->deficit > 0 ? 0 : ((uint64_t)(-member->deficit) + quantum)/quantum);
+			if(needed < rounds) rounds = needed;
+		}
+		for(unsigned i = 0; i < set->count; i++){
+			_tina_queue_set_member* member = &set->members[i];
+			if(_tina_queue_has_work(member->queue)) member->deficit += (int64_t)(rounds*member->weight*_TINA_QUEUE_SET_QUANTUM);
+		}
+	}
+}
+
+bool tina_scheduler_run_set(tina_scheduler* sched, tina_queue_set* set, tina_run_mode mode){
+	bool ran = false;
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		// Jobs in here don't have a worker, so hide the one from an outer run.
+		_tina_worker* prev_worker = _tina_current_worker;
+		_tina_current_worker = NULL;
+		
+		// Keep looping until the interrupt stamp is incremented.
+		unsigned stamp = set->interrupt_stamp;
+		while(mode != TINA_RUN_LOOP || set->interrupt_stamp == stamp){
+			if(sched->_timer_count) _tina_timer_update(sched);
+			_tina_queue_set_member* member;
+			tina_job* job = _tina_queue_set_next_job(set, &member);
+			if(job){
+				// Charge the queue for the time the job ran.
+				uint64_t start = _TINA_TIME_NS();
+				if(!_tina_scheduler_execute_job(sched, job)) continue;
+				member->deficit -= (int64_t)(_TINA_TIME_NS() - start);
+				ran = true;
+				if(mode == TINA_RUN_SINGLE) break;
+			} else if(mode == TINA_RUN_LOOP){
+				// Sleep until more work is added to any of the queues.
+				_tina_scheduler_idle(sched, &set->semaphore_signal, &set->semaphore_count);
+			} else {
+				break;
+			}
+		}
+		_tina_current_worker = prev_worker;
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+	return ran;
+}
+
+void tina_scheduler_interrupt_set(tina_scheduler* sched, tina_queue_set* set){
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		set->interrupt_stamp++;
+		
+		_TINA_COND_BROADCAST(set->semaphore_signal);
+		set->semaphore_count = 0;
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+size_t tina_subscription_size(unsigned count){
+	return _tina_jobs_align(sizeof(tina_subscription)) + count*sizeof(_tina_subscription_link);
+}
+
+tina_subscription* tina_subscription_init(void* buffer, tina_scheduler* sched, const unsigned* queue_idxs, unsigned count){
+	_TINA_ASSERT(count > 0, "Tina Jobs Error: Subscription must not be empty.");
+	tina_subscription* sub = (tina_subscription*)buffer;
+	sub->links = (_tina_subscription_link*)((uint8_t*)buffer + _tina_jobs_align(sizeof(tina_subscription)));
+	sub->count = count;
+	_TINA_COND_INIT(sub->semaphore_signal);
+	sub->semaphore_count = 0;
+	sub->interrupt_stamp = 0;
+	
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		for(unsigned i = 0; i < count; i++){
+			_tina_queue* queue = _tina_get_queue(sched, queue_idxs[i]);
+			_tina_subscription_link link = {.queue = queue, .sub = sub, .next = queue->subscribers};
+			sub->links[i] = link;
+			queue->subscribers = &sub->links[i];
+		}
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+	
+	return sub;
+}
+
+void tina_subscription_destroy(tina_scheduler* sched, tina_subscription* sub){
 	_TINA_MUTEX_LOCK(sched->_lock); {
+		// Unlink from each queue's list of subscribers.
+		for(unsigned i = 0; i < sub->count; i++){
+			_tina_subscription_link** cursor = &sub->links[i].queue->subscribers;
+			while(*cursor != &sub->links[i]) cursor = &(*cursor)->next;
+			(*cursor) = sub->links[i].next;
+		}
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+	_TINA_COND_DESTROY(sub->semaphore_signal);
+}
+
+#ifndef TINA_NO_CRT
+tina_subscription* tina_subscription_new(tina_scheduler* sched, const unsigned* queue_idxs, unsigned count){
+	void* buffer = malloc(tina_subscription_size(count));
+	return tina_subscription_init(buffer, sched, queue_idxs, count);
+}
+
+void tina_subscription_free(tina_scheduler* sched, tina_subscription* sub){
+	tina_subscription_destroy(sched, sub);
+	free(sub);
+}
+#endif
+
+bool tina_scheduler_run_subscription(tina_scheduler* sched, tina_subscription* sub, tina_run_mode mode){
+	bool ran = false;
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		// Jobs in here don't have a worker, so hide the one from an outer run.
+		_tina_worker* prev_worker = _tina_current_worker;
+		_tina_current_worker = NULL;
+		
+		// Keep looping until the interrupt stamp is incremented.
+		unsigned stamp = sub->interrupt_stamp;
+		while(mode != TINA_RUN_LOOP || sub->interrupt_stamp == stamp){
+			if(sched->_timer_count) _tina_timer_update(sched);
+			
+			// Take a job from the first queue that has one.
+			tina_job* job = NULL;
+			for(unsigned i = 0; i < sub->count && !job; i++) job = _tina_queue_next_job(sub->links[i].queue);
+			
+			if(job){
+				if(!_tina_scheduler_execute_job(sched, job)) continue;
+				ran = true;
+				if(mode == TINA_RUN_SINGLE) break;
+			} else if(mode == TINA_RUN_LOOP){
+				// Sleep until more work is added to any of the queues.
+				_tina_scheduler_idle(sched, &sub->semaphore_signal, &sub->semaphore_count);
+			} else {
+				break;
+			}
+		}
+		_tina_current_worker = prev_worker;
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+	return ran;
+}
+
+void tina_scheduler_interrupt_subscription(tina_scheduler* sched, tina_subscription* sub){
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		sub->interrupt_stamp++;
+		
+		_TINA_COND_BROADCAST(sub->semaphore_signal);
+		sub->semaphore_count = 0;
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+static unsigned _tina_scheduler_enqueue_batch(tina_scheduler* sched, const tina_job_description* list, unsigned count, tina_group* group, unsigned max_group_count, bool partial){
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		_tina_scheduler_grow_jobs(sched, count);
+		if(partial && count > sched->_job_pool.count) count = (unsigned)sched->_job_pool.count;
 		if(group) count = _tina_group_increment(group, count, max_group_count);
 		
 		_TINA_ASSERT(sched->_job_pool.count >= count, "Tina Jobs Error: Ran out of jobs.");
 		for(size_t i = 0; i < count; i++){
-			_TINA_ASSERT(list[i].func, "Tina Jobs Error: Job must have a body function.");
-			
-			// Pop a job from the pool.
-			tina_job* job = (tina_job*)sched->_job_pool.arr[--sched->_job_pool.count];
-			tina_job job_value = {.desc = list[i], .user_data = NULL, .fiber = NULL, .group = group, .wait_next = NULL, .wait_threshold = 0};
-			(*job) = job_value;
-			
-			// Push it to the proper queue.
-			_tina_queue* queue = _tina_get_queue(sched, list[i].queue_idx);
-			queue->arr[queue->head++ & queue->mask] = job;
-			_tina_queue_signal(queue);
+			// Pop a job from the pool and push it to the proper queue.
+			tina_job* job = _tina_scheduler_new_job(sched, &list[i], group);
+			_tina_queue_spawn(_tina_get_queue(sched, list[i].queue_idx), job);
 		}
 	} _TINA_MUTEX_UNLOCK(sched->_lock);
 	
 	return count;
 }
 
+unsigned tina_scheduler_enqueue_batch(tina_scheduler* sched, const tina_job_description* list, unsigned count, tina_group* group, unsigned max_group_count){
+	return _tina_scheduler_enqueue_batch(sched, list, count, group, max_group_count, false);
+}
+
+unsigned tina_scheduler_try_enqueue_batch(tina_scheduler* sched, const tina_job_description* list, unsigned count, tina_group* group, unsigned max_group_count){
+	return _tina_scheduler_enqueue_batch(sched, list, count, group, max_group_count, true);
+}
+
+void tina_scheduler_enqueue_after(tina_scheduler* sched, const tina_job_description* desc, tina_group* group, tina_group* wait_group, unsigned threshold){
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		if(group) _tina_group_increment(group, 1, 0);
+		
+		_tina_scheduler_grow_jobs(sched, 1);
+		_TINA_ASSERT(sched->_job_pool.count > 0, "Tina Jobs Error: Ran out of jobs.");
+		tina_job* job = _tina_scheduler_new_job(sched, desc, group);
+		_tina_queue* queue = _tina_get_queue(sched, desc->queue_idx);
+		
+		if(wait_group->_count > threshold){
+			// Park the job on the wait list without a fiber. It will start fresh when it's woken.
+			job->wait_threshold = threshold;
+			job->wait_next = wait_group->_job_list;
+			wait_group->_job_list = job;
+		} else {
+			_tina_queue_push(queue, job);
+		}
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+uint64_t tina_scheduler_now(tina_scheduler* sched){return _TINA_TIME_NS();}
+
+void tina_scheduler_enqueue_at(tina_scheduler* sched, const tina_job_description* desc, tina_group* group, uint64_t deadline){
+	_TINA_MUTEX_LOCK(sched->_lock); {
+		if(group) _tina_group_increment(group, 1, 0);
+		
+		_tina_scheduler_grow_jobs(sched, 1);
+		_TINA_ASSERT(sched->_job_pool.count > 0, "Tina Jobs Error: Ran out of jobs.");
+		tina_job* job = _tina_scheduler_new_job(sched, desc, group);
+		job->timer_deadline = deadline;
+		_tina_timer_add(sched, job, _TINA_TIME_NS());
+	} _TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
 void tina_scheduler_enqueue_n(tina_scheduler* sched, tina_job_func* func, void* user_data, unsigned count, unsigned queue_idx, tina_group* group){
 	unsigned cursor = 0;
 	tina_job_description desc[256];
 	
 	for(unsigned i = 0; i < count; i++){
 		// Push description
-		tina_job_description description = {.name = NULL, .func = func, .user_data = user_data, .user_idx = i, .queue_idx = queue_idx};
+		tina_job_description description = {.name = NULL, .func = func, .user_data = user_data, .user_idx = i, .queue_idx = queue_idx, .deadline = 0, .priority = 0, .stack_class = 0};
 		desc[cursor++] = description;
 		
 		// Check if the buffer is full.
@@ -469,30 +2330,170 @@ void tina_scheduler_enqueue_n(tina_scheduler* sched, tina_job_func* func, void*
 	if(cursor) tina_scheduler_enqueue_batch(sched, desc, cursor, group, 0);
 }
 
-unsigned tina_job_wait(tina_job* job, tina_group* group, unsigned threshold){
-	_TINA_MUTEX_LOCK(tina_job_get_scheduler(job)->_lock);
-	
-	// Check if we need to wait at all.
-	unsigned count = group->_count;
-	if(count > threshold){
-		// Push onto wait list.
-		job->wait_next = group->_job_list;
-		group->_job_list = job;
+// Check if a job that hasn't started yet fits on a waiting job's stack.
+static inline bool _tina_job_fits_stack(tina_scheduler* sched, tina_job* job, tina_job* waiter){
+	return sched->_stack_classes[_tina_job_stack_class(sched, job)].stack_size <= _tina_job_fiber_pool(sched, waiter)->stack_size;
+}
+
+// Take a job from 'group' that hasn't started yet out of the queue, so a waiting job can run it nested.
+static tina_job* _tina_queue_take_helper(tina_scheduler* sched, _tina_queue* queue, tina_group* group, tina_job* waiter){
+	// The waiter is running, so it's worker is too.
+	_tina_worker* worker = waiter->last_worker;
+	if(worker && worker->queue == queue){
+		tina_job* job = worker->runnext;
+		if(job && job->group == group && job->fiber == NULL && _tina_job_fits_stack(sched, job, waiter)){
+			worker->runnext = NULL;
+			queue->runnext_count--;
+			return job;
+		}
+	}
+	if(queue->mode != TINA_QUEUE_FIFO) return NULL;
+	
+	// Search back from the newest jobs since that's where the waiter's children will be.
+	size_t count = queue->head - queue->tail;
+	if(count > _TINA_HELP_SEARCH) count = _TINA_HELP_SEARCH;
+	for(size_t i = queue->head - 1; count; i--, count--){
+		tina_job* job = (tina_job*)queue->arr[i & queue->mask];
+		if(job->group != group || job->fiber != NULL || !_tina_job_fits_stack(sched, job, waiter)) continue;
 		
-		job->wait_threshold = threshold;
-		// NOTE: Scheduler will be unlocked after yielding.
-		tina_yield(job->fiber, (void*)_TINA_STATUS_WAITING);
-		job->wait_threshold = 0;
+		// Close the gap so the rest of the queue stays in order.
+		for(; i + 1 != queue->head; i++) queue->arr[i & queue->mask] = queue->arr[(i + 1) & queue->mask];
+		queue->head--;
+		return job;
+	}
+	return NULL;
+}
+
+// Run a job directly on a waiting job's fiber. If it suspends, the waiter stays suspended underneath it until it finishes.
+static void _tina_job_run_nested(tina_scheduler* sched, tina_job* job, tina_job* nested){
+	nested->fiber = job->fiber;
+	nested->stack_class = job->stack_class;
+	nested->help_depth = job->help_depth + 1;
+	nested->last_worker = job->last_worker;
+	nested->slice_start = job->slice_start;
+	nested->slice_length = job->slice_length;
+	nested->desc.func(nested);
+	
+	unsigned queue_idx = nested->desc.queue_idx;
+	uint64_t now = nested->desc.deadline ? _TINA_TIME_NS() : 0;
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_job_finish(sched, nested, now);
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+	
+	// The nested job switched queues and took the fiber with it, so go back to the waiter's queue.
+	if(queue_idx != job->desc.queue_idx) _tina_job_suspend(job, _TINA_STATUS_YIELDING);
+}
+
+unsigned tina_job_wait(tina_job* job, tina_group* group, unsigned threshold){
+	tina_scheduler* sched = tina_job_get_scheduler(job);
+	_tina_queue* queue = &sched->_queues[job->desc.queue_idx];
+	
+	while(true){
+		// Check if we need to wait at all.
+		_TINA_MUTEX_LOCK(sched->_lock);
+		unsigned count = group->_count;
+		// Only the group's own jobs are safe to help with. They have to finish before the waiter can continue anyway.
+		tina_job* nested = NULL;
+		if(count > threshold && job->help_depth < queue->help_depth) nested = _tina_queue_take_helper(sched, queue, group, job);
+		_TINA_MUTEX_UNLOCK(sched->_lock);
+		if(count <= threshold) return count;
 		
-		return group->_count;
+		if(!nested) break;
+		_tina_job_run_nested(sched, job, nested);
+	}
+	
+	// The scheduler checks the group again and parks the job after the fiber has switched out.
+	job->wait_group = group;
+	job->wait_threshold = threshold;
+	_tina_job_suspend(job, _TINA_STATUS_WAITING);
+	job->wait_group = NULL;
+	job->wait_threshold = 0;
+	
+	return group->_count;
+}
+
+static void _tina_job_capacity_park(tina_job* job, void* ctx){
+	tina_scheduler* sched = tina_job_get_scheduler(job);
+	_TINA_MUTEX_LOCK(sched->_lock);
+	bool waiting = sched->_job_pool.count == 0;
+	// Unlike other parked jobs, the lock guards it while it waits. So it can be hibernated like a waiting job.
+	// Otherwise it could hold the fiber a woken hibernated job needs to finish and free up room in the pool.
+	if(sched->_hibernate) _tina_hibernate_release(sched, _tina_job_fiber_pool(sched, job), job->fiber, job, waiting);
+	if(waiting){
+		job->wait_next = sched->_capacity_waiters;
+		sched->_capacity_waiters = job;
 	} else {
-		_TINA_MUTEX_UNLOCK(tina_job_get_scheduler(job)->_lock);
-		return count;
+		// Jobs finished while this one was switching out.
+		_tina_queue_push(&sched->_queues[job->desc.queue_idx], job);
+	}
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_job_enqueue_batch(tina_job* job, const tina_job_description* list, unsigned count, tina_group* group){
+	tina_scheduler* sched = tina_job_get_scheduler(job);
+	while(true){
+		unsigned added = tina_scheduler_try_enqueue_batch(sched, list, count, group, 0);
+		list += added, count -= added;
+		if(count == 0) return;
+		
+		// Wait for a job to finish and return to the pool.
+		tina_job_park(job, _tina_job_capacity_park, NULL);
 	}
 }
 
 void tina_job_yield(tina_job* job){
-	tina_yield(job->fiber, (void*)_TINA_STATUS_YIELDING);
+	_tina_job_suspend(job, _TINA_STATUS_YIELDING);
+}
+
+bool tina_job_check_yield(tina_job* job){
+	uintptr_t elapsed = tina_job_get_scheduler(job)->_slice_clock - job->slice_start;
+	if(job->slice_length == 0 || elapsed < job->slice_length) return false;
+	_tina_job_suspend(job, _TINA_STATUS_YIELDING);
+	return true;
+}
+
+// Check if a queue has jobs without taking the lock. A stale answer only means yielding a little early or late.
+static inline bool _tina_queue_pending(_tina_queue* queue){
+	if(*(volatile unsigned*)&queue->runnext_count != 0) return true;
+	return *(volatile size_t*)&queue->head != *(volatile size_t*)&queue->tail || *(volatile size_t*)&queue->heap_count != 0;
+}
+
+bool tina_job_yield_if_pending(tina_job* job){
+	tina_scheduler* sched = tina_job_get_scheduler(job);
+	for(_tina_queue* queue = &sched->_queues[job->desc.queue_idx]; queue; queue = queue->parent){
+		if(_tina_queue_pending(queue)){
+			_tina_job_suspend(job, _TINA_STATUS_YIELDING);
+			return true;
+		}
+	}
+	return false;
+}
+
+void tina_job_park(tina_job* job, tina_job_park_func* func, void* ctx){
+	job->park_func = func;
+	job->park_ctx = ctx;
+	_tina_job_suspend(job, _TINA_STATUS_PARKED);
+	job->park_func = NULL;
+	job->park_ctx = NULL;
+}
+
+void tina_job_unpark(tina_job* job){
+	tina_scheduler* sched = tina_job_get_scheduler(job);
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_queue_push(&sched->_queues[job->desc.queue_idx], job);
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+static void _tina_job_sleep_park(tina_job* job, void* ctx){
+	tina_scheduler* sched = tina_job_get_scheduler(job);
+	_TINA_MUTEX_LOCK(sched->_lock);
+	_tina_timer_add(sched, job, _TINA_TIME_NS());
+	_TINA_MUTEX_UNLOCK(sched->_lock);
+}
+
+void tina_job_sleep(tina_job* job, uint64_t ns){
+	job->timer_deadline = _TINA_TIME_NS() + ns;
+	tina_job_park(job, _tina_job_sleep_park, NULL);
 }
 
 unsigned tina_job_switch_queue(tina_job* job, unsigned queue_idx){
@@ -500,7 +2501,7 @@ unsigned tina_job_switch_queue(tina_job* job, unsigned queue_idx){
 	if(queue_idx == old_queue) return queue_idx;
 	
 	job->desc.queue_idx = queue_idx;
-	tina_yield(job->fiber, (void*)_TINA_STATUS_YIELDING);
+	_tina_job_suspend(job, _TINA_STATUS_YIELDING);
 	return old_queue;
 }
 
@@ -0,0 +1,664 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#ifndef TINA_JOBS_HPP
+#define TINA_JOBS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <tuple>
+
+#if __cpp_impl_coroutine
+	#include <coroutine>
+#endif
+
+#if __has_include(<version>)
+	#include <version>
+#endif
+
+#include "tina.hpp"
+#include "tina_jobs.h"
+
+namespace tina_cpp {
+
+// Pooled storage for job closures that are too big (or not trivial enough) to store inline in a job.
+// Blocks are carved out of chunks in a few size classes, and recycled through free lists so steady state spawning doesn't allocate.
+// Closures bigger than the largest class are rejected at compile time. Box them yourself if you really need that.
+class closure_arena {
+public:
+	// Block sizes are 64, 256 and 1024 bytes.
+	static constexpr size_t CLASS_COUNT = 3;
+	static constexpr size_t CHUNK_BLOCKS = 64;
+	static constexpr size_t MAX_SIZE = (size_t)64 << 2*(CLASS_COUNT - 1);
+
+	static constexpr size_t class_size(size_t class_idx){return (size_t)64 << 2*class_idx;}
+	static constexpr size_t class_for(size_t size){
+		size_t class_idx = 0;
+		while(((size_t)64 << 2*class_idx) < size) class_idx++;
+		return class_idx;
+	}
+
+	closure_arena() noexcept = default;
+	closure_arena(const closure_arena&) = delete;
+	closure_arena& operator=(const closure_arena&) = delete;
+
+	~closure_arena(){
+		for(auto& size_class : _classes){
+			while(size_class.chunks){
+				chunk* next = size_class.chunks->next;
+				std::free(size_class.chunks);
+				size_class.chunks = next;
+			}
+		}
+	}
+
+	void* acquire(size_t class_idx){
+		size_class& size_class = _classes[class_idx];
+		lock_guard guard(size_class.lock);
+
+		if(!size_class.free_list){
+			// Carve a new chunk into blocks and push them onto the free list.
+			const size_t block_size = class_size(class_idx);
+			chunk* c = (chunk*)std::malloc(sizeof(chunk) + CHUNK_BLOCKS*block_size);
+			if(!c) throw std::bad_alloc();
+			c->next = size_class.chunks;
+			size_class.chunks = c;
+
+			char* blocks = (char*)(c + 1);
+			for(size_t i = 0; i < CHUNK_BLOCKS; i++){
+				block* b = (block*)(blocks + i*block_size);
+				b->next = size_class.free_list;
+				size_class.free_list = b;
+			}
+		}
+
+		block* b = size_class.free_list;
+		size_class.free_list = b->next;
+		return b;
+	}
+
+	void release(size_t class_idx, void* ptr) noexcept {
+		size_class& size_class = _classes[class_idx];
+		lock_guard guard(size_class.lock);
+
+		block* b = (block*)ptr;
+		b->next = size_class.free_list;
+		size_class.free_list = b;
+	}
+
+private:
+	struct block {block* next;};
+	// Chunk headers are padded to keep the blocks following them maximally aligned.
+	struct alignas(std::max_align_t) chunk {chunk* next;};
+
+	// Spawning is short and rarely contended, so a spinlock is plenty. (Also avoids <mutex> clashing with C11 thread shims)
+	struct lock_guard {
+		std::atomic_flag& flag;
+		lock_guard(std::atomic_flag& flag) noexcept : flag(flag) {while(flag.test_and_set(std::memory_order_acquire)){}}
+		~lock_guard(){flag.clear(std::memory_order_release);}
+	};
+
+	struct size_class {
+		std::atomic_flag lock = ATOMIC_FLAG_INIT;
+		block* free_list = nullptr;
+		chunk* chunks = nullptr;
+	} _classes[CLASS_COUNT];
+};
+
+// Move only RAII wrapper for a tina_scheduler that can spawn C++ callables as jobs.
+class scheduler {
+public:
+	scheduler(unsigned job_count, unsigned queue_count, unsigned fiber_count, size_t stack_size)
+		: _sched(tina_scheduler_new(job_count, queue_count, fiber_count, stack_size)), _arena(new closure_arena()) {}
+
+	scheduler(scheduler&& other) noexcept : _sched(other._sched), _arena(other._arena) {other._sched = nullptr; other._arena = nullptr;}
+	scheduler& operator=(scheduler&& other) noexcept {std::swap(_sched, other._sched); std::swap(_arena, other._arena); return *this;}
+	scheduler(const scheduler&) = delete;
+	scheduler& operator=(const scheduler&) = delete;
+
+	// Any unfinished jobs will be lost, and their closures leaked. Flush your queues first.
+	~scheduler(){
+		if(_sched) tina_scheduler_free(_sched);
+		delete _arena;
+	}
+
+	// Get the underlying C scheduler.
+	tina_scheduler* get() const noexcept {return _sched;}
+	operator tina_scheduler*() const noexcept {return _sched;}
+
+	// Enqueue a callable as a job. It will be called as 'func(tina_job* job)'.
+	// Small trivially copyable callables (up to two pointers worth of captures) are stored inline in the job description.
+	// Anything else is move constructed into the scheduler's closure arena and destroyed after it runs.
+	// Callables must not throw, exceptions cannot propagate across fibers.
+	template<typename F>
+	void spawn(unsigned queue_idx, F&& func, tina_group* group = nullptr, const char* name = nullptr){
+		tina_job_description desc = {};
+		fill_description(desc, std::forward<F>(func));
+		desc.name = name;
+		desc.queue_idx = queue_idx;
+		tina_scheduler_enqueue_batch(_sched, &desc, 1, group, 0);
+	}
+
+	// Run jobs in the given queue, see tina_scheduler_run().
+	bool run(unsigned queue_idx, tina_run_mode mode){return tina_scheduler_run(_sched, queue_idx, mode);}
+	// Interrupt a queue, see tina_scheduler_interrupt().
+	void interrupt(unsigned queue_idx){tina_scheduler_interrupt(_sched, queue_idx);}
+
+	// Fill in 'func', 'user_data' and 'user_idx' of a description to call a C++ callable.
+	// The description must be enqueued exactly once, otherwise a pooled closure will leak.
+	template<typename F>
+	void fill_description(tina_job_description& desc, F&& func){
+		using Fn = std::decay_t<F>;
+		static_assert(std::is_invocable_v<Fn&, tina_job*>, "Tina Jobs Error: Job must be callable as func(tina_job*).");
+
+		if constexpr(is_inline<Fn>){
+			uintptr_t words[2] = {};
+			std::memcpy(words, &func, sizeof(Fn));
+			desc.func = _inline_job<Fn>;
+			desc.user_data = (void*)words[0];
+			desc.user_idx = words[1];
+		} else {
+			static_assert(sizeof(Fn) <= closure_arena::MAX_SIZE, "Tina Jobs Error: Job closure is too large for the closure arena.");
+			static_assert(alignof(Fn) <= alignof(std::max_align_t), "Tina Jobs Error: Job closure is over aligned.");
+			desc.func = _pooled_job<Fn>;
+			desc.user_data = ::new(_arena->acquire(closure_arena::class_for(sizeof(Fn)))) Fn(std::forward<F>(func));
+			desc.user_idx = (uintptr_t)_arena;
+		}
+	}
+
+private:
+	tina_scheduler* _sched;
+	closure_arena* _arena;
+
+	template<typename Fn>
+	static constexpr bool is_inline = std::is_trivially_copyable_v<Fn> && sizeof(Fn) <= 2*sizeof(uintptr_t) && alignof(Fn) <= alignof(uintptr_t);
+
+	template<typename Fn>
+	static void _inline_job(tina_job* job){
+		const tina_job_description* desc = tina_job_get_description(job);
+		uintptr_t words[2] = {(uintptr_t)desc->user_data, desc->user_idx};
+		alignas(Fn) unsigned char storage[sizeof(Fn)];
+		std::memcpy(storage, words, sizeof(Fn));
+		(*std::launder((Fn*)storage))(job);
+	}
+
+	template<typename Fn>
+	static void _pooled_job(tina_job* job){
+		const tina_job_description* desc = tina_job_get_description(job);
+		Fn* func = (Fn*)desc->user_data;
+		(*func)(job);
+		func->~Fn();
+		((closure_arena*)desc->user_idx)->release(closure_arena::class_for(sizeof(Fn)), func);
+	}
+};
+
+#if __cpp_impl_coroutine
+// Awaitables to let C++20 (stackless) coroutines run on tina_jobs queues.
+// Suspended coroutines are resumed by ordinary jobs, so they don't hold a fiber while waiting.
+// 'co_await' returns the tina_job the coroutine was resumed on, which is valid until the next suspension.
+
+template<typename Awaiter> void _resume_job(tina_job* job);
+
+// Awaitable that resumes the coroutine at the back of a queue.
+struct switch_to {
+	tina_scheduler* sched;
+	unsigned queue_idx;
+	tina_job* job = nullptr;
+	std::coroutine_handle<> handle = {};
+
+	switch_to(tina_scheduler* sched, unsigned queue_idx) noexcept : sched(sched), queue_idx(queue_idx) {}
+
+	bool await_ready() const noexcept {return false;}
+	void await_suspend(std::coroutine_handle<> h){
+		handle = h;
+		tina_scheduler_enqueue(sched, _resume_job<switch_to>, this, 0, queue_idx, nullptr);
+	}
+	tina_job* await_resume() const noexcept {return job;}
+};
+
+// Awaitable that resumes the coroutine on a queue once a group has 'threshold' or fewer remaining jobs.
+// Uses the same wait list as tina_job_wait(), but wakes up a fresh job instead of a parked fiber.
+struct wait {
+	tina_scheduler* sched;
+	tina_group* group;
+	unsigned queue_idx;
+	unsigned threshold;
+	tina_job* job = nullptr;
+	std::coroutine_handle<> handle = {};
+
+	wait(tina_scheduler* sched, tina_group* group, unsigned queue_idx, unsigned threshold = 0) noexcept
+		: sched(sched), group(group), queue_idx(queue_idx), threshold(threshold) {}
+
+	bool await_ready() const noexcept {return false;}
+	void await_suspend(std::coroutine_handle<> h){
+		handle = h;
+		tina_job_description desc = {};
+		desc.func = _resume_job<wait>;
+		desc.user_data = this;
+		desc.queue_idx = queue_idx;
+		tina_scheduler_enqueue_after(sched, &desc, nullptr, group, threshold);
+	}
+	tina_job* await_resume() const noexcept {return job;}
+};
+
+template<typename Awaiter>
+void _resume_job(tina_job* job){
+	Awaiter* awaiter = (Awaiter*)tina_job_get_description(job)->user_data;
+	awaiter->job = job;
+	awaiter->handle.resume();
+}
+
+// Return type for fire and forget C++20 coroutines. They start eagerly and free themselves when they finish.
+// Use a tina_group (and tina_group_decrement() at the end of the coroutine) if you need to know when they are done.
+struct detached {
+	struct promise_type {
+		detached get_return_object() noexcept {return {};}
+		std::suspend_never initial_suspend() noexcept {return {};}
+		std::suspend_never final_suspend() noexcept {return {};}
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept {std::terminate();}
+	};
+};
+#endif
+
+// Sender/receiver support for tina_jobs queues, modeled after P2300 (std::execution).
+// Schedulers, senders, operation states and receivers follow it's member function protocol, and declare their concepts,
+// completion signatures and environments. The standard library doesn't ship it yet, so tina_cpp::exec provides the vocabulary.
+// Adaptors compose with pipes: 'jobs.schedule() | tina_cpp::then(f) | tina_cpp::bulk(n, g)'.
+// Completions are delivered from inside a job, so downstream work runs on a fiber and may call tina_job_wait(), etc.
+// Use jobs_scheduler::current_job() at the start of a completion to get the job it's running on.
+// NOTE: Errors are fatal, and stop requests aren't supported. Senders only complete with 'set_stopped()' if a predecessor did.
+// NOTE: The adaptors only support predecessors with a single value completion signature.
+
+namespace exec {
+	struct sender_t {};
+	struct receiver_t {};
+	struct operation_state_t {};
+	struct scheduler_t {};
+	
+	struct set_value_t {
+		template<typename Receiver, typename... Values>
+		void operator()(Receiver&& rcvr, Values&&... values) const noexcept {std::forward<Receiver>(rcvr).set_value(std::forward<Values>(values)...);}
+	};
+	struct set_error_t {
+		template<typename Receiver, typename Error>
+		void operator()(Receiver&& rcvr, Error&& err) const noexcept {std::forward<Receiver>(rcvr).set_error(std::forward<Error>(err));}
+	};
+	struct set_stopped_t {
+		template<typename Receiver>
+		void operator()(Receiver&& rcvr) const noexcept {std::forward<Receiver>(rcvr).set_stopped();}
+	};
+	inline constexpr set_value_t set_value{};
+	inline constexpr set_error_t set_error{};
+	inline constexpr set_stopped_t set_stopped{};
+	
+	template<typename... Signatures> struct completion_signatures {};
+	template<typename Sender, typename... Env>
+	using completion_signatures_of_t = typename std::decay_t<Sender>::completion_signatures;
+	
+	struct empty_env {};
+	
+	template<typename T, typename = void> struct _has_env : std::false_type {};
+	template<typename T> struct _has_env<T, std::void_t<decltype(std::declval<const T&>().get_env())>> : std::true_type {};
+	
+	struct get_env_t {
+		template<typename T>
+		auto operator()(const T& obj) const noexcept {
+			if constexpr(_has_env<T>::value){
+				return obj.get_env();
+			} else {
+				return empty_env{};
+			}
+		}
+	};
+	inline constexpr get_env_t get_env{};
+	
+	template<typename Tag>
+	struct get_completion_scheduler_t {
+		template<typename Env>
+		auto operator()(const Env& env) const noexcept -> decltype(env.query(std::declval<get_completion_scheduler_t>())) {return env.query(*this);}
+	};
+	template<typename Tag> inline constexpr get_completion_scheduler_t<Tag> get_completion_scheduler{};
+	
+	struct connect_t {
+		template<typename Sender, typename Receiver>
+		auto operator()(Sender&& sndr, Receiver&& rcvr) const -> decltype(std::forward<Sender>(sndr).connect(std::forward<Receiver>(rcvr))) {
+			return std::forward<Sender>(sndr).connect(std::forward<Receiver>(rcvr));
+		}
+	};
+	inline constexpr connect_t connect{};
+	template<typename Sender, typename Receiver>
+	using connect_result_t = decltype(connect(std::declval<Sender>(), std::declval<Receiver>()));
+	
+	struct start_t {
+		template<typename Operation>
+		void operator()(Operation& op) const noexcept {op.start();}
+	};
+	inline constexpr start_t start{};
+	
+	struct schedule_t {
+		template<typename Scheduler>
+		auto operator()(const Scheduler& sched) const noexcept -> decltype(sched.schedule()) {return sched.schedule();}
+	};
+	inline constexpr schedule_t schedule{};
+}
+
+// Values of a sender's value completion as a tuple, and back again.
+template<typename Signature> struct _is_value_signature : std::false_type {};
+template<typename... Values> struct _is_value_signature<exec::set_value_t(Values...)> : std::true_type {};
+
+template<typename Signature> struct _signature_values {using type = std::tuple<>;};
+template<typename... Values> struct _signature_values<exec::set_value_t(Values...)> {using type = std::tuple<std::decay_t<Values>...>;};
+
+template<typename Signatures> struct _completion_values;
+template<typename... Signatures> struct _completion_values<exec::completion_signatures<Signatures...>> {
+	static_assert((_is_value_signature<Signatures>::value + ... + 0) == 1, "Tina Jobs Error: Sender must have exactly one value completion signature.");
+	using type = decltype(std::tuple_cat(std::declval<typename _signature_values<Signatures>::type>()...));
+};
+template<typename Sender> using _sender_values_t = typename _completion_values<exec::completion_signatures_of_t<Sender>>::type;
+
+template<typename Tuple> struct _value_signature;
+template<typename... Values> struct _value_signature<std::tuple<Values...>> {using type = exec::set_value_t(Values...);};
+
+inline tina_job*& _jobs_current_job() noexcept {
+	static thread_local tina_job* job = nullptr;
+	return job;
+}
+
+// Deliver a completion from inside of a job.
+template<typename Func>
+void _jobs_complete(tina_job* job, Func&& func){
+	_jobs_current_job() = job;
+	func();
+	// The job may have migrated threads if the completion waited, so clear whichever thread it's on now.
+	_jobs_current_job() = nullptr;
+}
+
+class jobs_scheduler;
+
+// Environment of a sender that completes on a jobs_scheduler's queue.
+struct _jobs_env {
+	tina_scheduler* sched;
+	unsigned queue_idx;
+	
+	jobs_scheduler query(exec::get_completion_scheduler_t<exec::set_value_t>) const noexcept;
+};
+
+class jobs_scheduler {
+public:
+	using scheduler_concept = exec::scheduler_t;
+	
+	jobs_scheduler(tina_scheduler* sched, unsigned queue_idx) noexcept : _sched(sched), _queue_idx(queue_idx) {}
+	bool operator==(const jobs_scheduler& other) const noexcept {return _sched == other._sched && _queue_idx == other._queue_idx;}
+	bool operator!=(const jobs_scheduler& other) const noexcept {return !(*this == other);}
+
+	tina_scheduler* get_scheduler() const noexcept {return _sched;}
+	unsigned get_queue_idx() const noexcept {return _queue_idx;}
+
+	// The job that is delivering the current completion on this thread.
+	// Grab it before suspending the job, it's not updated if the job moves to another thread.
+	static tina_job* current_job() noexcept {return _jobs_current_job();}
+
+	template<typename Receiver>
+	struct schedule_op {
+		using operation_state_concept = exec::operation_state_t;
+		
+		tina_scheduler* sched;
+		unsigned queue_idx;
+		Receiver rcvr;
+
+		void start() & noexcept {tina_scheduler_enqueue(sched, _job, this, 0, queue_idx, nullptr);}
+
+		static void _job(tina_job* job){
+			schedule_op* op = (schedule_op*)tina_job_get_description(job)->user_data;
+			_jobs_complete(job, [op]{std::move(op->rcvr).set_value();});
+		}
+	};
+
+	// Sender that completes with 'set_value()' from a job on the scheduler's queue.
+	struct schedule_sender {
+		using sender_concept = exec::sender_t;
+		using completion_signatures = exec::completion_signatures<exec::set_value_t()>;
+		
+		tina_scheduler* sched;
+		unsigned queue_idx;
+
+		template<typename Receiver>
+		schedule_op<std::decay_t<Receiver>> connect(Receiver&& rcvr) const {return {sched, queue_idx, std::forward<Receiver>(rcvr)};}
+		_jobs_env get_env() const noexcept {return {sched, queue_idx};}
+	};
+
+	schedule_sender schedule() const noexcept {return {_sched, _queue_idx};}
+
+private:
+	tina_scheduler* _sched;
+	unsigned _queue_idx;
+};
+
+inline jobs_scheduler _jobs_env::query(exec::get_completion_scheduler_t<exec::set_value_t>) const noexcept {return {sched, queue_idx};}
+
+// Sender adaptor that completes with 'func(values...)' wherever the predecessor completed.
+template<typename Sender, typename Func>
+struct then_sender {
+	using sender_concept = exec::sender_t;
+	using _result = decltype(std::apply(std::declval<Func&>(), std::declval<_sender_values_t<Sender>>()));
+	using completion_signatures = exec::completion_signatures<
+		std::conditional_t<std::is_void_v<_result>, exec::set_value_t(), exec::set_value_t(_result)>, exec::set_stopped_t()
+	>;
+	
+	template<typename Receiver>
+	struct receiver {
+		using receiver_concept = exec::receiver_t;
+		
+		Func func;
+		Receiver rcvr;
+		
+		template<typename... Values>
+		void set_value(Values&&... values) && noexcept {
+			if constexpr(std::is_void_v<_result>){
+				func(std::forward<Values>(values)...);
+				std::move(rcvr).set_value();
+			} else {
+				std::move(rcvr).set_value(func(std::forward<Values>(values)...));
+			}
+		}
+		template<typename Error> void set_error(Error&& err) && noexcept {std::move(rcvr).set_error(std::forward<Error>(err));}
+		void set_stopped() && noexcept {std::move(rcvr).set_stopped();}
+		auto get_env() const noexcept {return exec::get_env(rcvr);}
+	};
+	
+	Sender pred;
+	Func func;
+	
+	template<typename Receiver>
+	exec::connect_result_t<Sender, receiver<std::decay_t<Receiver>>> connect(Receiver&& rcvr) && {
+		return exec::connect(std::move(pred), receiver<std::decay_t<Receiver>>{std::move(func), std::forward<Receiver>(rcvr)});
+	}
+	auto get_env() const noexcept {return exec::get_env(pred);}
+};
+
+template<typename Func> struct _then_closure {Func func;};
+
+template<typename Sender, typename Func>
+then_sender<std::decay_t<Sender>, std::decay_t<Func>> then(Sender&& sndr, Func&& func){return {std::forward<Sender>(sndr), std::forward<Func>(func)};}
+template<typename Func>
+_then_closure<std::decay_t<Func>> then(Func&& func){return {std::forward<Func>(func)};}
+template<typename Sender, typename Func>
+auto operator|(Sender&& sndr, _then_closure<Func> closure){return then(std::forward<Sender>(sndr), std::move(closure.func));}
+
+// Sender adaptor that runs 'func(idx, values...)' for each index in [0, count) as a batch of jobs (via tina_scheduler_enqueue_n()).
+// The predecessor must complete on a jobs_scheduler, and the batch runs on it's queue. Completes with the predecessor's values
+// from a job on that queue once all of them have finished, without holding a fiber while it waits.
+template<typename Sender, typename Func>
+struct bulk_sender {
+	using sender_concept = exec::sender_t;
+	using _values = _sender_values_t<Sender>;
+	using completion_signatures = exec::completion_signatures<typename _value_signature<_values>::type, exec::set_stopped_t()>;
+	
+	template<typename Receiver>
+	struct op {
+		using operation_state_concept = exec::operation_state_t;
+		
+		struct receiver {
+			using receiver_concept = exec::receiver_t;
+			
+			op* self;
+			
+			template<typename... Values>
+			void set_value(Values&&... values) && noexcept {
+				self->values.emplace(std::forward<Values>(values)...);
+				tina_scheduler* sched = self->sched.get_scheduler();
+				unsigned queue_idx = self->sched.get_queue_idx();
+				tina_scheduler_enqueue_n(sched, _bulk_job, self, self->count, queue_idx, &self->group);
+				
+				tina_job_description desc = {};
+				desc.func = _done_job;
+				desc.user_data = self;
+				desc.queue_idx = queue_idx;
+				tina_scheduler_enqueue_after(sched, &desc, nullptr, &self->group, 0);
+			}
+			template<typename Error> void set_error(Error&& err) && noexcept {std::move(self->rcvr).set_error(std::forward<Error>(err));}
+			void set_stopped() && noexcept {std::move(self->rcvr).set_stopped();}
+			auto get_env() const noexcept {return exec::get_env(self->rcvr);}
+		};
+		
+		jobs_scheduler sched;
+		unsigned count;
+		Func func;
+		Receiver rcvr;
+		std::optional<_values> values = {};
+		tina_group group = {};
+		exec::connect_result_t<Sender, receiver> pred_op;
+		
+		template<typename R>
+		op(Sender&& pred, unsigned count, Func&& func, R&& rcvr)
+			: sched(exec::get_completion_scheduler<exec::set_value_t>(exec::get_env(pred))), count(count), func(std::move(func)),
+			rcvr(std::forward<R>(rcvr)), pred_op(exec::connect(std::move(pred), receiver{this})) {}
+		
+		void start() & noexcept {exec::start(pred_op);}
+		
+		static void _bulk_job(tina_job* job){
+			const tina_job_description* desc = tina_job_get_description(job);
+			op* self = (op*)desc->user_data;
+			std::apply([self, desc](auto&... values){self->func((unsigned)desc->user_idx, values...);}, *self->values);
+		}
+		
+		static void _done_job(tina_job* job){
+			op* self = (op*)tina_job_get_description(job)->user_data;
+			_jobs_complete(job, [self]{
+				std::apply([self](auto&... values){std::move(self->rcvr).set_value(std::move(values)...);}, *self->values);
+			});
+		}
+	};
+	
+	static_assert(std::is_same_v<decltype(exec::get_completion_scheduler<exec::set_value_t>(exec::get_env(std::declval<const Sender&>()))), jobs_scheduler>,
+		"Tina Jobs Error: bulk() must follow a sender that completes on a jobs_scheduler.");
+	
+	Sender pred;
+	unsigned count;
+	Func func;
+	
+	template<typename Receiver>
+	op<std::decay_t<Receiver>> connect(Receiver&& rcvr) && {
+		return op<std::decay_t<Receiver>>(std::move(pred), count, std::move(func), std::forward<Receiver>(rcvr));
+	}
+	auto get_env() const noexcept {return exec::get_env(pred);}
+};
+
+template<typename Func> struct _bulk_closure {unsigned count; Func func;};
+
+template<typename Sender, typename Func>
+bulk_sender<std::decay_t<Sender>, std::decay_t<Func>> bulk(Sender&& sndr, unsigned count, Func&& func){
+	return {std::forward<Sender>(sndr), count, std::forward<Func>(func)};
+}
+template<typename Func>
+_bulk_closure<std::decay_t<Func>> bulk(unsigned count, Func&& func){return {count, std::forward<Func>(func)};}
+template<typename Sender, typename Func>
+auto operator|(Sender&& sndr, _bulk_closure<Func> closure){return bulk(std::forward<Sender>(sndr), closure.count, std::move(closure.func));}
+
+// Sender adaptor that starts all of 'senders' and completes with all of their values once they are done.
+// Completes from whichever child finished last, or with 'set_stopped()' if any of them were stopped.
+template<typename... Senders>
+struct when_all_sender {
+	using sender_concept = exec::sender_t;
+	using _values = decltype(std::tuple_cat(std::declval<_sender_values_t<Senders>>()...));
+	using completion_signatures = exec::completion_signatures<typename _value_signature<_values>::type, exec::set_stopped_t()>;
+	
+	template<typename Receiver, typename Indexes> struct op;
+	template<typename Receiver, size_t... I>
+	struct op<Receiver, std::index_sequence<I...>> {
+		using operation_state_concept = exec::operation_state_t;
+		
+		template<size_t Idx>
+		struct child_receiver {
+			using receiver_concept = exec::receiver_t;
+			
+			op* self;
+			
+			template<typename... Values>
+			void set_value(Values&&... values) && noexcept {
+				std::get<Idx>(self->values).emplace(std::forward<Values>(values)...);
+				self->child_done();
+			}
+			template<typename Error> void set_error(Error&&) && noexcept {std::terminate();}
+			void set_stopped() && noexcept {self->stopped = true; self->child_done();}
+			auto get_env() const noexcept {return exec::get_env(self->rcvr);}
+		};
+		
+		// Lets the (possibly immovable) child operation states be constructed in place inside the tuple.
+		template<typename Func>
+		struct emplacer {
+			Func func;
+			operator std::invoke_result_t<Func&>() {return func();}
+		};
+		template<typename Func>
+		static emplacer<Func> emplace(Func func){return {func};}
+		
+		Receiver rcvr;
+		std::atomic<size_t> remaining = sizeof...(Senders);
+		std::atomic<bool> stopped = false;
+		std::tuple<std::optional<_sender_values_t<Senders>>...> values;
+		std::tuple<exec::connect_result_t<Senders, child_receiver<I>>...> children;
+		
+		template<typename R>
+		op(R&& rcvr, std::tuple<Senders...>& senders)
+			: rcvr(std::forward<R>(rcvr)), children(emplace([&]{return exec::connect(std::move(std::get<I>(senders)), child_receiver<I>{this});})...) {}
+		
+		void start() & noexcept {
+			if constexpr(sizeof...(Senders) == 0){
+				std::move(rcvr).set_value();
+			} else {
+				std::apply([](auto&... ops){(exec::start(ops), ...);}, children);
+			}
+		}
+		
+		void child_done() noexcept {
+			if(remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+			
+			if(stopped){
+				std::move(rcvr).set_stopped();
+			} else {
+				std::apply([this](auto&&... values){std::move(rcvr).set_value(std::move(values)...);}, std::tuple_cat(std::move(*std::get<I>(values))...));
+			}
+		}
+	};
+	
+	std::tuple<Senders...> senders;
+	
+	template<typename Receiver>
+	op<std::decay_t<Receiver>, std::index_sequence_for<Senders...>> connect(Receiver&& rcvr) && {
+		return {std::forward<Receiver>(rcvr), senders};
+	}
+};
+
+template<typename... Senders>
+when_all_sender<std::decay_t<Senders>...> when_all(Senders&&... senders){
+	return {std::tuple<std::decay_t<Senders>...>(std::forward<Senders>(senders)...)};
+}
+
+} // namespace tina_cpp
+
+#endif // TINA_JOBS_HPP
@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 Scott Lembcke and Howling Moon Software
+
+#ifndef TINA_RUNLOOP_H
+#define TINA_RUNLOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A single threaded run loop for plain tina coroutines. (ex: cutscene or AI scripts that are resumed once per frame)
+// Only runnable coroutines are visited each tick. Sleeping coroutines are parked in a hierarchical timing wheel.
+// Coroutines in a run loop should suspend themselves with tina_sleep(), tina_wait_until(), or tina_yield(coro, NULL).
+// Yielding NULL simply resumes the coroutine again on the next tick. Yielding other values is not allowed.
+
+// Opaque type for a run loop.
+typedef struct tina_runloop tina_runloop;
+
+// Predicate function for tina_wait_until(). Return true when the coroutine should be resumed.
+typedef bool tina_predicate(tina* coro, void* ctx);
+
+// Get the allocation size for a run loop that can hold up to 'capacity' coroutines.
+size_t tina_runloop_size(unsigned capacity);
+// Initialize memory for a run loop. Use tina_runloop_size() to figure out how much you need.
+tina_runloop* tina_runloop_init(void* buffer, unsigned capacity);
+
+#ifndef TINA_NO_CRT
+// Convenience constructor. Allocate and initialize a run loop.
+tina_runloop* tina_runloop_new(unsigned capacity);
+// Convenience destructor. Free a run loop. Coroutines still in the loop are not freed.
+void tina_runloop_free(tina_runloop* loop);
+#endif
+
+// Add a coroutine to the run loop. It will be resumed on the next tick. Returns false if the run loop is full.
+bool tina_runloop_add(tina_runloop* loop, tina* coro);
+// Advance the run loop by one tick, waking any sleeping coroutines that are due and resuming every runnable coroutine once.
+// Coroutines are removed from the loop when they complete, but their memory is still yours to free.
+// Returns the number of coroutines that were resumed.
+unsigned tina_runloop_tick(tina_runloop* loop);
+// Get the number of times the run loop has ticked.
+uint64_t tina_runloop_time(const tina_runloop* loop);
+// Get the number of coroutines in the run loop. (runnable, sleeping, or waiting)
+unsigned tina_runloop_count(const tina_runloop* loop);
+
+// Suspend a coroutine in a run loop for 'ticks' ticks. Sleeping for 0 or 1 ticks resumes it on the next tick.
+void tina_sleep(tina* coro, uint64_t ticks);
+// Suspend a coroutine in a run loop until 'predicate(coro, ctx)' returns true.
+// Waiting coroutines are polled once per tick, so prefer tina_sleep() when you know how long to wait.
+void tina_wait_until(tina* coro, tina_predicate* predicate, void* ctx);
+
+#ifdef TINA_RUNLOOP_IMPLEMENTATION
+
+#ifndef TINA_NO_CRT
+	#include <stdlib.h>
+#endif
+
+// 4 levels of 64 slots covers 2^24 ticks. Longer sleeps are cascaded through the top level again.
+#define _TINA_WHEEL_BITS 6
+#define _TINA_WHEEL_SLOTS (1 << _TINA_WHEEL_BITS)
+#define _TINA_WHEEL_MASK (_TINA_WHEEL_SLOTS - 1)
+#define _TINA_WHEEL_LEVELS 4
+
+// Alignment of the entries that follow the runloop in it's buffer. (Same as tina.h, which only defines it for it's own implementation)
+#define _TINA_RUNLOOP_ALIGN ((size_t)16)
+
+typedef struct _tina_runloop_entry _tina_runloop_entry;
+struct _tina_runloop_entry {
+	tina* coro;
+	_tina_runloop_entry* next;
+	// Tick to wake up on if sleeping.
+	uint64_t deadline;
+	// Predicate to poll if waiting.
+	tina_predicate* predicate;
+	void* ctx;
+};
+
+// Simple singly linked FIFO list.
+typedef struct {
+	_tina_runloop_entry *head, *tail;
+} _tina_runloop_list;
+
+struct tina_runloop {
+	uint64_t _time;
+	unsigned _count;
+
+	_tina_runloop_entry* _pool;
+	// Coroutines to resume on the next tick.
+	_tina_runloop_list _ready;
+	// Coroutines waiting on a predicate.
+	_tina_runloop_list _waiting;
+	// Sleeping coroutines.
+	_tina_runloop_entry* _wheel[_TINA_WHEEL_LEVELS][_TINA_WHEEL_SLOTS];
+};
+
+// Value yielded by tina_sleep() and tina_wait_until().
+typedef struct {
+	uint64_t ticks;
+	tina_predicate* predicate;
+	void* ctx;
+} _tina_runloop_request;
+
+size_t tina_runloop_size(unsigned capacity){
+	return -(-sizeof(tina_runloop) & -_TINA_RUNLOOP_ALIGN) + capacity*sizeof(_tina_runloop_entry);
+}
+
+tina_runloop* tina_runloop_init(void* buffer, unsigned capacity){
+	tina_runloop* loop = (tina_runloop*)buffer;
+	tina_runloop loop_value = {._time = 0, ._count = 0, ._pool = NULL};
+	(*loop) = loop_value;
+
+	// Fill the entry pool.
+	_tina_runloop_entry* entries = (_tina_runloop_entry*)((uint8_t*)buffer + -(-sizeof(tina_runloop) & -_TINA_RUNLOOP_ALIGN));
+	for(unsigned i = 0; i < capacity; i++){
+		entries[i].next = loop->_pool;
+		loop->_pool = &entries[i];
+	}
+
+	return loop;
+}
+
+#ifndef TINA_NO_CRT
+tina_runloop* tina_runloop_new(unsigned capacity){
+	return tina_runloop_init(malloc(tina_runloop_size(capacity)), capacity);
+}
+
+void tina_runloop_free(tina_runloop* loop){
+	free(loop);
+}
+#endif
+
+static inline void _tina_runloop_list_push(_tina_runloop_list* list, _tina_runloop_entry* entry){
+	entry->next = NULL;
+	if(list->tail){
+		list->tail->next = entry;
+	} else {
+		list->head = entry;
+	}
+	list->tail = entry;
+}
+
+// Insert a sleeping entry into the wheel. The level is picked by how far away the deadline is.
+static void _tina_runloop_schedule(tina_runloop* loop, _tina_runloop_entry* entry){
+	uint64_t delta = entry->deadline - loop->_time;
+	if(entry->deadline <= loop->_time){
+		_tina_runloop_list_push(&loop->_ready, entry);
+		return;
+	}
+
+	unsigned level = 0;
+	while(level < _TINA_WHEEL_LEVELS - 1 && delta >> (_TINA_WHEEL_BITS*(level + 1))) level++;
+
+	// Deadlines past the end of the top level are parked in it's furthest slot and rescheduled when it cascades.
+	uint64_t deadline = entry->deadline;
+	uint64_t max_delta = ((uint64_t)1 << (_TINA_WHEEL_BITS*_TINA_WHEEL_LEVELS)) - 1;
+	if(delta > max_delta) deadline = loop->_time + max_delta;
+
+	_tina_runloop_entry** slot = &loop->_wheel[level][(deadline >> (_TINA_WHEEL_BITS*level)) & _TINA_WHEEL_MASK];
+	entry->next = *slot;
+	*slot = entry;
+}
+
+static void _tina_runloop_advance(tina_runloop* loop){
+	uint64_t time = ++loop->_time;
+
+	// Find the highest level that wrapped around, then cascade it's current slot down starting from the top.
+	unsigned levels = 1;
+	while(levels < _TINA_WHEEL_LEVELS && (time & (((uint64_t)1 << (_TINA_WHEEL_BITS*levels)) - 1)) == 0) levels++;
+	for(unsigned level = levels - 1; level > 0; level--){
+		_tina_runloop_entry** slot = &loop->_wheel[level][(time >> (_TINA_WHEEL_BITS*level)) & _TINA_WHEEL_MASK];
+		_tina_runloop_entry* entry = *slot;
+		*slot = NULL;
+
+		while(entry){
+			_tina_runloop_entry* next = entry->next;
+			_tina_runloop_schedule(loop, entry);
+			entry = next;
+		}
+	}
+
+	// Everything in the current bottom level slot is due now.
+	_tina_runloop_entry** slot = &loop->_wheel[0][time & _TINA_WHEEL_MASK];
+	_tina_runloop_entry* entry = *slot;
+	*slot = NULL;
+	while(entry){
+		_tina_runloop_entry* next = entry->next;
+		_tina_runloop_list_push(&loop->_ready, entry);
+		entry = next;
+	}
+}
+
+bool tina_runloop_add(tina_runloop* loop, tina* coro){
+	_tina_runloop_entry* entry = loop->_pool;
+	if(!entry) return false;
+	loop->_pool = entry->next;
+
+	_tina_runloop_entry entry_value = {.coro = coro, .next = NULL, .deadline = 0, .predicate = NULL, .ctx = NULL};
+	(*entry) = entry_value;
+	_tina_runloop_list_push(&loop->_ready, entry);
+	loop->_count++;
+	return true;
+}
+
+unsigned tina_runloop_tick(tina_runloop* loop){
+	_tina_runloop_advance(loop);
+
+	// Poll the waiting coroutines.
+	_tina_runloop_entry** cursor = &loop->_waiting.head;
+	_tina_runloop_entry* prev = NULL;
+	while(*cursor){
+		_tina_runloop_entry* entry = *cursor;
+		if(entry->predicate(entry->coro, entry->ctx)){
+			// Unlink and move to the ready list.
+			*cursor = entry->next;
+			if(loop->_waiting.tail == entry) loop->_waiting.tail = prev;
+			_tina_runloop_list_push(&loop->_ready, entry);
+		} else {
+			prev = entry;
+			cursor = &entry->next;
+		}
+	}
+
+	// Take the ready list so coroutines that become runnable during this tick run on the next one.
+	_tina_runloop_entry* entry = loop->_ready.head;
+	loop->_ready.head = loop->_ready.tail = NULL;
+
+	unsigned resumed = 0;
+	while(entry){
+		_tina_runloop_entry* next = entry->next;
+		const _tina_runloop_request* request = (const _tina_runloop_request*)tina_resume(entry->coro, NULL);
+		resumed++;
+
+		if(entry->coro->completed){
+			// Return the entry to the pool.
+			entry->next = loop->_pool;
+			loop->_pool = entry;
+			loop->_count--;
+		} else if(request == NULL){
+			_tina_runloop_list_push(&loop->_ready, entry);
+		} else if(request->predicate){
+			entry->predicate = request->predicate;
+			entry->ctx = request->ctx;
+			_tina_runloop_list_push(&loop->_waiting, entry);
+		} else {
+			entry->deadline = loop->_time + (request->ticks ? request->ticks : 1);
+			_tina_runloop_schedule(loop, entry);
+		}
+
+		entry = next;
+	}
+
+	return resumed;
+}
+
+uint64_t tina_runloop_time(const tina_runloop* loop){return loop->_time;}
+unsigned tina_runloop_count(const tina_runloop* loop){return loop->_count;}
+
+void tina_sleep(tina* coro, uint64_t ticks){
+	_tina_runloop_request request = {.ticks = ticks, .predicate = NULL, .ctx = NULL};
+	tina_yield(coro, &request);
+}
+
+void tina_wait_until(tina* coro, tina_predicate* predicate, void* ctx){
+	// Skip the round trip if it's already true.
+	if(predicate(coro, ctx)) return;
+
+	_tina_runloop_request request = {.ticks = 0, .predicate = predicate, .ctx = ctx};
+	tina_yield(coro, &request);
+}
+
+#endif // TINA_RUNLOOP_IMPLEMENTATION
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TINA_RUNLOOP_H